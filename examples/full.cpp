@@ -22,9 +22,13 @@
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
 
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
+TguiCompositor compositor;
+TguiScreen ui = TguiScreen(&display, 8000);   // 8 ms of drawing per loop pass
+
 
 #ifdef USE_VL53L0X
-SensorVL53L0X tof = SensorVL53L0X(0x67, 100);
+SensorVL53L0X tof = SensorVL53L0X(0x67, 20);   // poll often, ranges arrive every 100 ms
 void tofGetData()
 {
     tof.updateData();
@@ -52,7 +56,6 @@ Label tofLable = Label(
     Label::DRAW_ON_RIGHT,
     VL53L0X_DISTANCE);
 
-uint32_t tofEventPreviousCounter = 0;
 RunningChart tofChart = RunningChart(
     {10, 110},
     {300, 100},
@@ -68,9 +71,7 @@ RunningChart tofChart = RunningChart(
 SensorSi1132 light = SensorSi1132(0x60, 100);
 void ligthGetData()
 {
-    light.updateIR();
-    light.updateUV();
-    light.updateVisible();
+    light.updateAll();
 }
 Ticker lightEvent(ligthGetData, light._reportInterval, 0);
 
@@ -118,10 +119,7 @@ Label irLable = Label(
 SensorBME280 bme = SensorBME280(0x76, 250);
 void bmeGetData()
 {
-    bme.updateHumidity();
-    bme.updateTemperature();
-    bme.updatePressure();
-    bme.updateAltitude();
+    bme.updateAll();
 }
 Ticker bmeEvent(bmeGetData, bme._reportInterval, 0);
 
@@ -206,7 +204,6 @@ Label altitudeLable = Label(
     Label::DRAW_ON_BOTTOM,
     BME280_ALTITUDE);
 
-uint32_t bmeEventPreviousCounter = 0;
 RunningChart humidityChart = RunningChart(
     {10, 190},
     {300, 45},
@@ -286,7 +283,6 @@ void airLabelUpdate()
 }
 Ticker airLabelEvent(airLabelUpdate, 500, 0);
 
-uint32_t airEventPreviousCounter = 0;
 XyPlot airPlot = XyPlot(
     {10, 40},
     {300, 190},
@@ -300,6 +296,12 @@ XyPlot airPlot = XyPlot(
     true);
 #endif
 
+void addWidget(TguiElement *widget, uint8_t priority = TguiScreen::PRIORITY_NORMAL)
+{
+    if (!ui.addOnSample(widget, priority))
+        Sprintln(F("Widget not scheduled, raise SCREEN_MAX_WIDGETS or SENSOR_MAX_LISTENERS"));
+}
+
 void initPins()
 {
     pinMode(backlightPin, OUTPUT);
@@ -322,107 +324,84 @@ void setup()
     Sprintln(F("Tgui showcase"));
 
     Wire.begin();    // Zforce lib uses a different I2C lib
-    InitializeScreen();
+    InitializeScreen(&display);
+    ui.compositor = &compositor;    // before adding, so every widget gets it
 
 #ifdef USE_BATTERY
     battery.init();
-    batteryPbar.init();
-    batteryVoltageLable.init();
+    addWidget(&batteryPbar, TguiScreen::PRIORITY_LOW);
+    addWidget(&batteryVoltageLable, TguiScreen::PRIORITY_LOW);
     batteryEvent.start();
 #endif
 
 #ifdef USE_VL53L0X
     tof.init();
-    tofPbar.init();
-    tofLable.init();
-    tofChart.init();
+    tofChart.setStyle(RunningChart::ENVELOPE, 10);  // one column per second at 10 Hz
+    addWidget(&tofPbar);
+    addWidget(&tofLable);
+    addWidget(&tofChart, TguiScreen::PRIORITY_NORMAL);
     tofEvent.start();
 #endif
 
 #ifdef USE_BME280
     bme.init();
-    // temperaturePbar.init();
-    // humidityPbar.init();
-    // pressurePbar.init();
-    // altitudePbar.init();
-    humidityLable.init();
-    temperatureLable.init();
-    pressureLable.init();
-    altitudeLable.init();
-    humidityChart.init();
+    // ui.add(&temperaturePbar);
+    // ui.add(&humidityPbar);
+    // ui.add(&pressurePbar);
+    // ui.add(&altitudePbar);
+    addWidget(&humidityLable);
+    addWidget(&temperatureLable);
+    addWidget(&pressureLable);
+    addWidget(&altitudeLable);
+    addWidget(&humidityChart, TguiScreen::PRIORITY_NORMAL);
     bmeEvent.start();
 #endif
 
 #ifdef USE_SI1132
     light.init();
-    lightPbar.init();
-    irPbar.init();
-    uvPbar.init();
-    irLable.init();
+    addWidget(&lightPbar);
+    addWidget(&irPbar);
+    addWidget(&uvPbar);
+    addWidget(&irLable);
     lightEvent.start();
 #endif
 
 #ifdef USE_ZFORCE
+    airX.bind(&display);
     airX.init();
+    airY.bind(&display);
     airY.init();
-    airPlot.init();
+    addWidget(&airPlot, TguiScreen::PRIORITY_CRITICAL);
     air.init();
     airEvent.start();
     airLabelEvent.start();
 #endif
+
+    ui.init();
 }
 
 void loop(void)
 {
 #ifdef USE_BATTERY
     batteryEvent.update();
-    batteryPbar.update();
-    batteryVoltageLable.update();
 #endif
 
 #ifdef USE_VL53L0X
     tofEvent.update();
-    tofPbar.update();
-    tofLable.update();
-    if(tofEvent.counter() != tofEventPreviousCounter)
-    {
-        tofChart.update();
-        tofEventPreviousCounter = tofEvent.counter();
-    }
 #endif
 
 #ifdef USE_BME280
     bmeEvent.update();
-    // humidityPbar.update();
-    // temperaturePbar.update();
-    // pressurePbar.update();
-    // altitudePbar.update();
-    humidityLable.update();
-    temperatureLable.update();
-    pressureLable.update();
-    altitudeLable.update();
-    if(bmeEvent.counter() != bmeEventPreviousCounter)
-    {
-        humidityChart.update();
-        bmeEventPreviousCounter = bmeEvent.counter();
-    }
 #endif
 
 #ifdef USE_SI1132
     lightEvent.update();
-    lightPbar.update();
-    irPbar.update();
-    uvPbar.update();
-    irLable.update();
 #endif
 
 #ifdef USE_ZFORCE
     airEvent.update();
     airLabelEvent.update();
-    if(airEvent.counter() != airEventPreviousCounter)
-    {
-        airPlot.update();
-        airEventPreviousCounter = airEvent.counter();
-    }
 #endif
+
+    ui.frame();
 }
@@ -19,6 +19,7 @@
 
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
 
 SensorBattery battery = SensorBattery(1000);
 void batteryGetData()
@@ -48,9 +49,10 @@ void setup()
     analogReference(INTERNAL);
     pinMode(backlightPin, OUTPUT);
     analogWrite(backlightPin, backlightPwm);
-    InitializeScreen();
+    InitializeScreen(&display);
 
     battery.init();
+    batteryVoltageLable.bind(&display);
     batteryVoltageLable.init();
     batteryEvent.start();
 }
@@ -17,15 +17,13 @@
 
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
 
 #ifdef USE_BME280
 SensorBME280 bme = SensorBME280(0x76, 250);
 void bmeGetData()
 {
-    bme.updateHumidity();
-    bme.updateTemperature();
-    bme.updatePressure();
-    bme.updateAltitude();
+    bme.updateAll();
 }
 Ticker bmeEvent(bmeGetData, bme._reportInterval, 0);
 
@@ -140,21 +138,29 @@ void setup()
     Sprintln(F("Tgui showcase"));
 
     Wire.begin();    // Zforce lib uses a different I2C lib
-    InitializeScreen();
+    InitializeScreen(&display);
 
 #ifdef USE_BATTERY
     battery.init();
+    batteryPbar.bind(&display);
     batteryPbar.init();
+    batteryVoltageLable.bind(&display);
     batteryVoltageLable.init();
     batteryEvent.start();
 #endif
 
 #ifdef USE_BME280
+    bme.setProfile(SensorBME280::WEATHER_STATION);   // one forced conversion per tick, asleep in between
     bme.init();
+    humidityLable.bind(&display);
     humidityLable.init();
+    temperatureLable.bind(&display);
     temperatureLable.init();
+    pressureLable.bind(&display);
     pressureLable.init();
+    altitudeLable.bind(&display);
     altitudeLable.init();
+    humidityChart.bind(&display);
     humidityChart.init();
     bmeEvent.start();
 #endif
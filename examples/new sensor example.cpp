@@ -15,13 +15,14 @@
 
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
 
 //------------------------- New sensor class --------------------------------/
 class SensorAdc : public Sensor
 {
 private:
     uint8_t _pin;
-    RunningMedian _filter = RunningMedian(FILTER_SAMPLE_SIZE);
+    MedianFilter<FILTER_SAMPLE_SIZE, 4> _filter;   // average of the middle 4 samples
     void addDataPoint(uint8_t channel, float data)
     {
         _filter.add(data);
@@ -34,7 +35,6 @@ public:
     {
         _pin = pin;
         _reportInterval = reportInterval;
-        _filterSize = 4;
     }
     void init()
     {
@@ -44,11 +44,11 @@ public:
     {
         if (getRawData)
         {
-            return _filter.getElement(_filter.getSize() - 1);
+            return _filter.latest();
         }
         else
         {
-            return _filter.getAverage(_filterSize);
+            return _filter.average();
         }
     }
     void updateValue()
@@ -108,10 +108,12 @@ void setup()
 
     pinMode(backlightPin, OUTPUT);
     analogWrite(backlightPin, backlightPwm);
-    InitializeScreen();
+    InitializeScreen(&display);
 
     adcPin.init();
+    adcChart.bind(&display);
     adcChart.init();
+    adcLabel.bind(&display);
     adcLabel.init();
     adcEvent.start();
     adcLabelEvent.start();
@@ -12,12 +12,9 @@
 #include <tgui.h>
 #include <tgui-sensors.h>
 
-#include <SPI.h>
-#include <Adafruit_ILI9340.h>
-
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
-Adafruit_ILI9340 tft = Adafruit_ILI9340(10, 9, 8);
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
 
 uint8_t countDigits(int num)
 {
@@ -56,7 +53,6 @@ public:
         _size = {110, 110};
         _color = foregroundColor;
         _sensor = sensor;
-        screen = &tft;
         _dataType = dataTypeUpper;
         _dataType2 = dataTypeLower;
         _value = 0;
@@ -114,11 +110,10 @@ void setup()
     analogWrite(backlightPin, backlightPwm);
     analogReference(INTERNAL);
 
-    tft.begin();
-    tft.setRotation(1);
-    tft.fillScreen(backgroundColor);
+    InitializeScreen(&display);
 
     battery.init();
+    batteryIndicator.bind(&display);
     batteryIndicator.init();
     batteryEvent.start();
 }
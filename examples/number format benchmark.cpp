@@ -0,0 +1,90 @@
+/*!
+ * @file main.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+
+/*
+ * Compares formatReading(), the fixed-point path every Label goes through,
+ * with Print::print(float). formatReading() picks the decimals that fit the
+ * label and retries with fewer when rounding carries, so it is timed as a
+ * whole. print(float) writes into a sink that discards the characters, so
+ * only the formatting cost is measured.
+ * The sweep is repeated BENCH_ROUNDS times so each total runs for
+ * milliseconds on a host and for seconds on an Uno, well above the
+ * resolution of micros().
+ * Results are printed over serial as "path,values,us_total,us_per_value".
+ * On the host it runs with "pio run -e native_number_format -t exec",
+ * where stdout stands in for serial.
+ */
+
+#include <Arduino.h>
+#include <tgui.h>
+
+#define BENCH_VALUES 200
+#define BENCH_ROUNDS 500
+#define BENCH_DECIMALS 1
+#define BENCH_WIDTH 6       // cells of the label, "1019.8"
+
+class NullPrint : public Print
+{
+public:
+    size_t write(uint8_t c) { return 1; }
+};
+
+NullPrint sink;
+volatile uint8_t keep;
+
+void report(const char *path, uint32_t elapsed)
+{
+    const uint32_t values = (uint32_t)BENCH_VALUES * BENCH_ROUNDS;
+    Serial.print(path);
+    Serial.print(',');
+    Serial.print(values);
+    Serial.print(',');
+    Serial.print(elapsed);
+    Serial.print(',');
+    Serial.println((float)elapsed / values, 3);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Serial.println(F("path,values,us_total,us_per_value"));
+}
+
+// typical pressure and humidity readings, 980.0 to 1019.8
+float sweepValue(uint16_t i)
+{
+    return 980.0 + i * 0.199;
+}
+
+void loop(void)
+{
+    uint32_t start = micros();
+    for (uint16_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint16_t i = 0; i < BENCH_VALUES; i++)
+        {
+            sink.print(sweepValue(i), BENCH_DECIMALS);
+        }
+    }
+    report("print_float", micros() - start);
+
+    char text[LABEL_MAX_CELLS + 1];
+    start = micros();
+    for (uint16_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint16_t i = 0; i < BENCH_VALUES; i++)
+        {
+            formatReading(text, BENCH_WIDTH, sweepValue(i), false);
+            keep = text[0];
+        }
+    }
+    report("format_reading", micros() - start);
+
+    delay(2000);
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file main.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+
+/*
+ * The same screen as "label progressBar runningChart BME280", built as a
+ * StaticScreen. Every widget knows its sensor channel and geometry at
+ * compile time, so the loop updates them through direct calls instead of
+ * vtables, and the widgets hold no sensor or display pointers.
+ */
+
+#include <Arduino.h>
+#include <Ticker.h>
+#include <tgui.h>
+#include <tgui-static.h>
+#include <tgui-sensors.h>
+
+const uint8_t backlightPin = 5;
+uint8_t backlightPwm = 255;
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
+
+SensorBME280 bme = SensorBME280(0x76, 250);
+void bmeGetData()
+{
+    bme.updateAll();
+}
+Ticker bmeEvent(bmeGetData, bme._reportInterval, 0);
+uint32_t bmeCounter() { return bmeEvent.counter(); }
+
+SensorBattery battery = SensorBattery(1000);
+void batteryGetData()
+{
+    battery.updateLevel();
+    battery.updateVoltage();
+}
+Ticker batteryEvent(batteryGetData, battery._reportInterval, 0);
+
+typedef StaticInput<SensorBME280, bme, BME280_HUMIDITY> Humidity;
+typedef StaticInput<SensorBME280, bme, BME280_TEMPERATURE> Temperature;
+typedef StaticInput<SensorBME280, bme, BME280_PRESSURE> Pressure;
+typedef StaticInput<SensorBME280, bme, BME280_ALTITUDE> Altitude;
+typedef StaticInput<SensorBattery, battery, BATTERY_LEVEL> BatteryLevel;
+typedef StaticInput<SensorBattery, battery, BATTERY_VOLTAGE> BatteryVoltage;
+
+typedef StaticProgressBar<278, 10, 32, 10, 6, 10, 8, 1, BatteryLevel> BatteryBar;
+typedef StaticLabel<200, 10, 2, 1, 4, Label::ONLY_INTEGER, Label::DRAW_ON_RIGHT, BatteryVoltage> BatteryLabel;
+typedef StaticLabel<20, 50, 5, 2, 4, Label::HAS_DECIMAL, Label::DRAW_ON_BOTTOM, Humidity> HumidityLabel;
+typedef StaticLabel<20, 120, 5, 2, 4, Label::HAS_DECIMAL, Label::DRAW_ON_BOTTOM, Temperature> TemperatureLabel;
+typedef StaticLabel<160, 50, 5, 2, 5, Label::HAS_DECIMAL, Label::DRAW_ON_BOTTOM, Pressure> PressureLabel;
+typedef StaticLabel<160, 120, 5, 2, 5, Label::HAS_DECIMAL, Label::DRAW_ON_BOTTOM, Altitude> AltitudeLabel;
+// one column per second at 4 Hz
+typedef StaticRunningChart<10, 190, 300, 45, 3, 0, 100, Humidity, RunningChart::ENVELOPE, 4> HumidityChart;
+typedef Triggered<HumidityChart, bmeCounter> HumidityChartOnEvent;
+
+StaticScreen<BatteryBar, BatteryLabel, HumidityLabel, TemperatureLabel, PressureLabel, AltitudeLabel, HumidityChartOnEvent> ui(
+    BatteryBar(foregroundColor),
+    BatteryLabel(foregroundColor, "mv"),
+    HumidityLabel(foregroundColor, "%"),
+    TemperatureLabel(foregroundColor, "c"),
+    PressureLabel(foregroundColor, "hPa"),
+    AltitudeLabel(foregroundColor, "m"),
+    HumidityChartOnEvent(HumidityChart(foregroundColor)));
+
+void initPins()
+{
+    pinMode(backlightPin, OUTPUT);
+    analogWrite(backlightPin, backlightPwm);
+
+    pinMode(3, OUTPUT);
+    pinMode(4, OUTPUT);
+    pinMode(6, OUTPUT);
+    pinMode(7, INPUT);
+    pinMode(A0, INPUT);
+    pinMode(A1, INPUT);
+    pinMode(A2, INPUT);
+}
+
+void setup()
+{
+    initPins();
+    analogReference(INTERNAL);
+    Serial.begin(115200);
+    Sprintln(F("Tgui showcase"));
+
+    Wire.begin();
+    InitializeScreen(&display);
+
+    battery.init();
+    bme.init();
+    ui.bind(&display);
+    ui.init();
+    batteryEvent.start();
+    bmeEvent.start();
+}
+
+void loop(void)
+{
+    batteryEvent.update();
+    bmeEvent.update();
+    ui.update();
+}
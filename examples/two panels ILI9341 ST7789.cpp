@@ -0,0 +1,139 @@
+/*!
+ * @file main.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+
+/*
+ * Two panels at once: the BME280 readings on an ILI9341 running at a higher
+ * SPI clock, and the battery on a small ST7789 status panel. Each widget is
+ * bound to the panel it draws on.
+ */
+
+#include <Arduino.h>
+#include <Ticker.h>
+#include <tgui.h>
+#include <tgui-sensors.h>
+
+#include <Adafruit_ILI9341.h>
+#include <Adafruit_ST7789.h>
+
+const uint8_t backlightPin = 5;
+uint8_t backlightPwm = 255;
+
+Adafruit_ILI9341 mainPanel = Adafruit_ILI9341(10, 9, 8);     // cs, dc, rst
+Adafruit_ST7789 statusPanel = Adafruit_ST7789(7, 6, 4);      // cs, dc, rst
+TguiSPITFT<Adafruit_ILI9341> mainDisplay = TguiSPITFT<Adafruit_ILI9341>(&mainPanel, 320);   // scrolls 320 lines
+TguiSPITFT<Adafruit_ST7789> statusDisplay = TguiSPITFT<Adafruit_ST7789>(&statusPanel);
+
+SensorBME280 bme = SensorBME280(0x76, 250);
+void bmeGetData()
+{
+    bme.updateAll();
+}
+Ticker bmeEvent(bmeGetData, bme._reportInterval, 0);
+
+SensorBattery battery = SensorBattery(1000);
+void batteryGetData()
+{
+    battery.updateLevel();
+    battery.updateVoltage();
+}
+Ticker batteryEvent(batteryGetData, battery._reportInterval, 0);
+
+Label humidityLable = Label(
+    {20, 50},
+    foregroundColor,
+    &bme,
+    "%",
+    5,
+    2,
+    Label::HAS_DECIMAL,
+    4,
+    Label::DRAW_ON_BOTTOM,
+    BME280_HUMIDITY);
+Label temperatureLable = Label(
+    {20, 120},
+    foregroundColor,
+    &bme,
+    "c",
+    5,
+    2,
+    Label::HAS_DECIMAL,
+    4,
+    Label::DRAW_ON_BOTTOM,
+    BME280_TEMPERATURE);
+RunningChart humidityChart = RunningChart(
+    {10, 190},
+    {300, 45},
+    3,
+    foregroundColor,
+    &bme,
+    BME280_HUMIDITY,
+    100,
+    0);
+
+ProgressBar batteryPbar = ProgressBar(
+    {20, 40},
+    {200, 20},
+    {6, 20},
+    8,
+    foregroundColor,
+    &battery,
+    1,
+    BATTERY_LEVEL);
+Label batteryVoltageLable = Label(
+    {20, 100},
+    foregroundColor,
+    &battery,
+    "mv",
+    4,
+    2,
+    Label::ONLY_INTEGER,
+    4,
+    Label::DRAW_ON_RIGHT,
+    BATTERY_VOLTAGE);
+
+TguiScreen mainScreen = TguiScreen(&mainDisplay);
+TguiScreen statusScreen = TguiScreen(&statusDisplay);
+uint32_t bmeCounter() { return bmeEvent.counter(); }
+
+void setup()
+{
+    pinMode(backlightPin, OUTPUT);
+    analogWrite(backlightPin, backlightPwm);
+    analogReference(INTERNAL);
+    Serial.begin(115200);
+    Sprintln(F("Tgui showcase"));
+
+    Wire.begin();
+    mainPanel.begin(40000000);
+    statusPanel.init(240, 240);
+    InitializeScreen(&mainDisplay);
+    InitializeScreen(&statusDisplay);
+
+    bme.init();
+    battery.init();
+
+    mainScreen.add(&humidityLable);
+    mainScreen.add(&temperatureLable);
+    mainScreen.add(&humidityChart, TguiScreen::PRIORITY_NORMAL, bmeCounter);
+    statusScreen.add(&batteryPbar);
+    statusScreen.add(&batteryVoltageLable);
+    mainScreen.init();
+    statusScreen.init();
+
+    bmeEvent.start();
+    batteryEvent.start();
+}
+
+void loop(void)
+{
+    bmeEvent.update();
+    batteryEvent.update();
+    mainScreen.frame();
+    statusScreen.frame();
+}
@@ -0,0 +1,297 @@
+/*!
+ * @file main.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+
+/*
+ * Feeds synthetic sensor traces through every widget type and measures the
+ * widget code in tgui.cpp against a headless framebuffer, so no panel is
+ * needed and SPI time does not hide the rendering cost.
+ * The traces are a slow BME280 humidity drift, noisy VL53L0X ranges with
+ * steps, and a zForce touch path. They are generated from a fixed seed, so
+ * every run sees the same samples.
+ * The Static* rows use the compile-time widgets of tgui-static.h and can be
+ * compared with the runtime widget on the row above. ram_bytes is the size
+ * of the widget object. It does not count the heap history of RunningChart
+ * or the heap trail of XyPlot, while StaticRunningChart holds its history
+ * inline.
+ * Results are printed over serial as CSV, one line per widget configuration:
+ * "widget,config,trace,ram_bytes,updates,ns_per_update,pixels_per_update,fills_per_update,windows_per_update"
+ * On the host it runs with "pio run -e native -t exec", where stdout
+ * stands in for serial.
+ */
+
+#include <Arduino.h>
+#include <tgui.h>
+#include <tgui-framebuffer.h>
+#include <tgui-static.h>
+
+#define BENCH_UPDATES 300
+
+class TraceSensor : public Sensor
+{
+public:
+    float samples[2];
+    bool lifted;
+    float readDataPoint(uint8_t channel = 0, bool getRawData = false) { return samples[channel]; }
+    uint16_t getParameters(uint16_t input) { return lifted; }   // touch state, as Touch reports it
+};
+
+typedef void (*TraceStep)(uint16_t index, float *samples);
+
+TraceSensor trace;
+TguiFramebuffer canvas(320, 240);   // counts only when it does not fit in RAM
+TguiCompositor compositor;
+
+typedef StaticInput<TraceSensor, trace, 0> TraceX;
+typedef StaticInput<TraceSensor, trace, 1> TraceY;
+
+// Lets the runner drive a static widget like a runtime one
+template <typename Widget>
+class StaticBench : public TguiElement
+{
+public:
+    Widget widget;
+    StaticBench(const Widget &w) : widget(w){};
+    void init() { widget.init(display); }
+    void update() { widget.update(display); }
+};
+
+//------------------------ Traces ---------------------------------------/
+uint16_t noiseState;
+
+// xorshift, uniform in [-amplitude, amplitude]
+int16_t noise(int16_t amplitude)
+{
+    noiseState ^= noiseState << 7;
+    noiseState ^= noiseState >> 9;
+    noiseState ^= noiseState << 8;
+    return (int16_t)(noiseState % (2 * amplitude + 1)) - amplitude;
+}
+
+// humidity in %, one sample every 250 ms
+void bmeDrift(uint16_t index, float *samples)
+{
+    samples[0] = 45.0 + index * 0.013 + noise(3) * 0.01;
+}
+
+// range in mm, a hand moving between two distances every five seconds at 10 Hz
+void tofNoisy(uint16_t index, float *samples)
+{
+    const int16_t base = ((index / 50) & 1) ? 650 : 300;
+    samples[0] = base + noise(25);
+}
+
+// touch coordinates in 0.1 mm, a figure eight over most of the frame,
+// with the finger lifted for the last tenth of every 100 samples
+void touchPath(uint16_t index, float *samples)
+{
+    trace.lifted = (index % 100) >= 90;
+    const float angle = index * 0.05;
+    samples[0] = 600 + 450 * sin(angle);
+    samples[1] = 600 + 400 * sin(2 * angle);
+}
+
+//------------------------ Widgets ---------------------------------------/
+Label integerLabel = Label(
+    {10, 50},
+    foregroundColor,
+    &trace,
+    "mm",
+    5,
+    2,
+    Label::ONLY_INTEGER,
+    4,
+    Label::DRAW_ON_RIGHT,
+    0);
+
+typedef StaticLabel<10, 50, 5, 2, 4, Label::ONLY_INTEGER, Label::DRAW_ON_RIGHT, TraceX> IntegerLabel;
+StaticBench<IntegerLabel> staticIntegerLabel = StaticBench<IntegerLabel>(IntegerLabel(foregroundColor, "mm"));
+
+Label decimalLabel = Label(
+    {10, 50},
+    foregroundColor,
+    &trace,
+    "%",
+    5,
+    2,
+    Label::HAS_DECIMAL,
+    4,
+    Label::DRAW_ON_BOTTOM,
+    0);
+
+typedef StaticLabel<10, 50, 5, 2, 4, Label::HAS_DECIMAL, Label::DRAW_ON_BOTTOM, TraceX> DecimalLabel;
+StaticBench<DecimalLabel> staticDecimalLabel = StaticBench<DecimalLabel>(DecimalLabel(foregroundColor, "%"));
+
+ProgressBar pbar = ProgressBar(
+    {10, 220},
+    {300, 12},
+    {4, 12},
+    5,
+    foregroundColor,
+    &trace,
+    10,
+    0);
+
+typedef StaticProgressBar<10, 220, 300, 12, 4, 12, 5, 10, TraceX> Bar;
+StaticBench<Bar> staticPbar = StaticBench<Bar>(Bar(foregroundColor));
+
+RunningChart chart = RunningChart(
+    {10, 110},
+    {300, 100},
+    3,
+    foregroundColor,
+    &trace,
+    0,
+    1000,
+    20);
+
+typedef StaticRunningChart<10, 110, 300, 100, 3, 20, 1000, TraceX> BarChart;
+StaticBench<BarChart> staticChart = StaticBench<BarChart>(BarChart(foregroundColor));
+
+typedef StaticRunningChart<10, 110, 300, 100, 3, 20, 1000, TraceX, RunningChart::ENVELOPE, 10> EnvelopeChart;
+StaticBench<EnvelopeChart> staticEnvelopeChart = StaticBench<EnvelopeChart>(EnvelopeChart(foregroundColor));
+
+XyPlot plot = XyPlot(
+    {10, 40},
+    {300, 190},
+    1,
+    foregroundColor,
+    &trace,
+    0,
+    {0, 1200},
+    1,
+    {0, 1200});
+
+typedef StaticXyPlot<10, 40, 300, 190, 0, 1200, 0, 1200, TraceX, TraceY> Plot;
+StaticBench<Plot> staticPlot = StaticBench<Plot>(Plot(foregroundColor));
+
+XyPlot trailPlot = XyPlot(
+    {10, 40},
+    {300, 190},
+    1,
+    foregroundColor,
+    &trace,
+    0,
+    {0, 1200},
+    1,
+    {0, 1200},
+    true);
+
+XyPlot fadePlot = XyPlot(
+    {10, 40},
+    {300, 190},
+    1,
+    foregroundColor,
+    &trace,
+    0,
+    {0, 1200},
+    1,
+    {0, 1200},
+    true,
+    true);
+
+//------------------------ Runner ---------------------------------------/
+void printPerUpdate(uint32_t total)
+{
+    Serial.print(',');
+    Serial.print((float)total / BENCH_UPDATES, 1);
+}
+
+// Start a trace over from its first sample, so every pass sees the same data
+void restartTrace(TraceStep step)
+{
+    noiseState = 0xACE1;
+    trace.lifted = false;
+    step(0, trace.samples);
+}
+
+void run(const char *widget, const char *config, const char *traceName, TraceStep step, TguiElement *element, uint16_t bytes, TguiCompositor *elementCompositor = NULL)
+{
+    // one update costs less than the 1 us tick of micros(), so whole loops
+    // are timed: first the trace on its own, then trace and widget together
+    restartTrace(step);
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < BENCH_UPDATES; i++)
+    {
+        step(i, trace.samples);
+    }
+    const uint32_t traceTime = micros() - start;
+
+    element->bind(&canvas);
+    element->compositor = elementCompositor;
+    restartTrace(step);
+    canvas.fillScreen(backgroundColor);
+    element->init();
+
+    uint32_t pixels = 0;
+    uint32_t fills = 0;
+    uint32_t windows = 0;
+    start = micros();
+    for (uint16_t i = 0; i < BENCH_UPDATES; i++)
+    {
+        step(i, trace.samples);
+        const FramebufferStats cost = canvas.measure(element);
+        pixels += cost.pixels;
+        fills += cost.fills;
+        windows += cost.windows;
+    }
+    const uint32_t total = micros() - start;
+    const uint32_t elapsed = (total > traceTime) ? total - traceTime : 0;
+
+    Serial.print(widget);
+    Serial.print(',');
+    Serial.print(config);
+    Serial.print(',');
+    Serial.print(traceName);
+    Serial.print(',');
+    Serial.print(bytes);
+    Serial.print(',');
+    Serial.print(BENCH_UPDATES);
+    Serial.print(',');
+    Serial.print((float)elapsed * 1000 / BENCH_UPDATES, 0);
+    printPerUpdate(pixels);
+    printPerUpdate(fills);
+    printPerUpdate(windows);
+    Serial.println();
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    compositor.bind(&canvas);
+    Serial.println(F("widget,config,trace,ram_bytes,updates,ns_per_update,pixels_per_update,fills_per_update,windows_per_update"));
+}
+
+void loop(void)
+{
+    run("Label", "integer", "tof_noisy", tofNoisy, &integerLabel, sizeof(integerLabel));
+    run("StaticLabel", "integer", "tof_noisy", tofNoisy, &staticIntegerLabel, sizeof(staticIntegerLabel.widget));
+    run("Label", "decimal", "bme_drift", bmeDrift, &decimalLabel, sizeof(decimalLabel));
+    run("StaticLabel", "decimal", "bme_drift", bmeDrift, &staticDecimalLabel, sizeof(staticDecimalLabel.widget));
+
+    run("ProgressBar", "direct", "tof_noisy", tofNoisy, &pbar, sizeof(pbar));
+    run("ProgressBar", "compositor", "tof_noisy", tofNoisy, &pbar, sizeof(pbar), &compositor);
+    run("StaticProgressBar", "direct", "tof_noisy", tofNoisy, &staticPbar, sizeof(staticPbar.widget));
+
+    chart.setStyle(RunningChart::BAR);
+    run("RunningChart", "bar", "tof_noisy", tofNoisy, &chart, sizeof(chart));
+    run("StaticRunningChart", "bar", "tof_noisy", tofNoisy, &staticChart, sizeof(staticChart.widget));
+    run("RunningChart", "bar", "bme_drift", bmeDrift, &chart, sizeof(chart));
+    chart.setStyle(RunningChart::ENVELOPE, 10);
+    run("RunningChart", "envelope_10", "tof_noisy", tofNoisy, &chart, sizeof(chart));
+    run("StaticRunningChart", "envelope_10", "tof_noisy", tofNoisy, &staticEnvelopeChart, sizeof(staticEnvelopeChart.widget));
+    chart.setStyle(RunningChart::LINE);
+    run("RunningChart", "line", "tof_noisy", tofNoisy, &chart, sizeof(chart));
+
+    run("XyPlot", "cursor", "touch_path", touchPath, &plot, sizeof(plot));
+    run("StaticXyPlot", "cursor", "touch_path", touchPath, &staticPlot, sizeof(staticPlot.widget));
+    run("XyPlot", "trail", "touch_path", touchPath, &trailPlot, sizeof(trailPlot));
+    run("XyPlot", "fade_trail", "touch_path", touchPath, &fadePlot, sizeof(fadePlot));
+
+    delay(5000);
+}
@@ -16,6 +16,7 @@
 
 const uint8_t backlightPin = 5;
 uint8_t backlightPwm = 255;
+TguiILI9340 display = TguiILI9340(10, 9, 8);   // cs, dc, rst
 
 #ifdef USE_ZFORCE
 Touch air = Touch(15);
@@ -90,11 +91,14 @@ void setup()
     Sprintln(F("Tgui showcase"));
 
     Wire.begin();    // Zforce lib uses a different I2C lib
-    InitializeScreen();
+    InitializeScreen(&display);
 
 #ifdef USE_ZFORCE
+    airX.bind(&display);
     airX.init();
+    airY.bind(&display);
     airY.init();
+    airPlot.bind(&display);
     airPlot.init();
     air.init();
     airEvent.start();
@@ -45,22 +45,58 @@ boolean ODROID_Si1132::begin(void)
 	return true;
 }
 
+// The sensor measures on its own every 8 ms (MEASRATE0 in begin()), so the
+// result registers are always fresh enough to read without waiting
 uint16_t ODROID_Si1132::readUV()
 {
-	delay(10);
-	return read16(0x2c);
+	return read16(Si1132_REG_UVINDEX0);
 }
 
 float ODROID_Si1132::readIR()
 {
-	delay(10);
-	return read16(0x24) - 250;
+	return removeDarkOffset(read16(Si1132_REG_ALSIRDATA0));
 }
 
 float ODROID_Si1132::readVisible()
 {
-	delay(10);
-	return read16(0x22) - 250;
+	return removeDarkOffset(read16(Si1132_REG_ALSVISDATA0));
+}
+
+// Readings below the dark level are noise, not negative light
+float ODROID_Si1132::removeDarkOffset(uint16_t raw)
+{
+	return raw > Si1132_DARK_OFFSET ? raw - Si1132_DARK_OFFSET : 0;
+}
+
+// True once a measurement finished since the last readAll(), without
+// blocking. The INT pin goes low at the same moment when it is wired up.
+boolean ODROID_Si1132::dataReady()
+{
+	return (read8(Si1132_REG_IRQSTAT) & Si1132_REG_IRQSTAT_ALS) != 0;
+}
+
+// All three channels in one bus transaction, then acknowledge the sample
+boolean ODROID_Si1132::readAll(float *visible, float *ir, uint16_t *uv)
+{
+	uint8_t data[Si1132_BURST_SIZE];
+
+	Wire.beginTransmission(_addr);
+	Wire.write((uint8_t)Si1132_REG_ALSVISDATA0);
+	if (Wire.endTransmission() != 0)
+		return false;
+
+	if (Wire.requestFrom(_addr, (uint8_t)Si1132_BURST_SIZE) != Si1132_BURST_SIZE)
+		return false;
+	for (uint8_t i = 0; i < Si1132_BURST_SIZE; i++)
+		data[i] = Wire.read();
+
+	write8(Si1132_REG_IRQSTAT, Si1132_REG_IRQSTAT_ALS);
+
+	*visible = removeDarkOffset(data[0] | (uint16_t)data[1] << 8);
+	*ir = removeDarkOffset(data[2] | (uint16_t)data[3] << 8);
+	*uv = data[Si1132_REG_UVINDEX0 - Si1132_REG_ALSVISDATA0] |
+		(uint16_t)data[Si1132_REG_UVINDEX1 - Si1132_REG_ALSVISDATA0] << 8;
+	return true;
 }
 
 void ODROID_Si1132::reset()
@@ -69,6 +69,7 @@
 #define Si1132_REG_COMMAND	0x18
 #define Si1132_REG_RESPONSE	0x20
 #define Si1132_REG_IRQSTAT	0x21
+#define Si1132_REG_IRQSTAT_ALS	0x01
 
 #define Si1132_REG_ALSVISDATA0	0x22
 #define Si1132_REG_ALSVISDATA1	0x23
@@ -81,6 +82,10 @@
 
 #define Si1132_ADDR 0x60
 
+// VIS, IR, four unused bytes, then UV: 0x22 to 0x2D in one read
+#define Si1132_BURST_SIZE	(Si1132_REG_UVINDEX1 - Si1132_REG_ALSVISDATA0 + 1)
+#define Si1132_DARK_OFFSET	250
+
 class ODROID_Si1132 {
 	public :
 		ODROID_Si1132(void);
@@ -90,12 +95,15 @@ class ODROID_Si1132 {
 		uint16_t readUV(void);
 		float readVisible(void);
 		float readIR(void);
+		boolean dataReady(void);
+		boolean readAll(float *visible, float *ir, uint16_t *uv);
 	private :
 		uint16_t read16(uint8_t addr);
 		uint8_t read8(uint8_t addr);
 		void write8(uint8_t reg, uint8_t val);
 		uint8_t readParam(uint8_t p);
 		uint8_t writeParam(uint8_t p, uint8_t v);
+		float removeDarkOffset(uint16_t raw);
 		uint8_t _addr;
 };
 	
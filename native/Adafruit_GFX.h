@@ -0,0 +1,80 @@
+/*!
+ * @file Adafruit_GFX.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+/*
+ * The Adafruit_GFX interface that Tgui draws through, with the same virtual
+ * methods, so TguiFramebuffer overrides them as it does on a board. The
+ * shapes Tgui uses are drawn with the same primitives as the library. Text
+ * uses a font where every glyph is a solid 5x7 block: digits that widgets
+ * draw from the glyph table in tgui.cpp are exact, other text is not.
+ */
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print
+{
+    protected:
+        int16_t WIDTH;
+        int16_t HEIGHT;
+        int16_t _width;
+        int16_t _height;
+        int16_t cursor_x;
+        int16_t cursor_y;
+        uint16_t textcolor;
+        uint16_t textbgcolor;
+        uint8_t textsize_x;
+        uint8_t textsize_y;
+        uint8_t rotation;
+        bool wrap;
+
+    public:
+        Adafruit_GFX(int16_t w, int16_t h);
+
+        virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+        virtual void startWrite(void){};
+        virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); };
+        virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); };
+        virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); };
+        virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); };
+        virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+        virtual void endWrite(void){};
+
+        virtual void setRotation(uint8_t r);
+        virtual void invertDisplay(bool){};
+
+        virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+        virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+        virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); };
+        virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+        virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+        void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+        void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+        void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+        void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; };
+        void setTextColor(uint16_t c) { textcolor = textbgcolor = c; };
+        void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; };
+        void setTextSize(uint8_t s) { textsize_x = textsize_y = (s > 0) ? s : 1; };
+        void setTextWrap(bool w) { wrap = w; };
+
+        virtual size_t write(uint8_t c);
+        using Print::write;
+
+        int16_t width(void) const { return _width; };
+        int16_t height(void) const { return _height; };
+        uint8_t getRotation(void) const { return rotation; };
+        int16_t getCursorX(void) const { return cursor_x; };
+        int16_t getCursorY(void) const { return cursor_y; };
+
+    private:
+        void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color);
+};
@@ -0,0 +1,34 @@
+/*!
+ * @file Adafruit_ILI9340.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+/*
+ * Declarations only, so tgui-display.h compiles. There is no panel on the
+ * host and a sketch that constructs TguiILI9340 will not link.
+ */
+
+#include <Adafruit_GFX.h>
+
+#define ILI9340_TFTWIDTH 240
+#define ILI9340_TFTHEIGHT 320
+
+class Adafruit_ILI9340 : public Adafruit_GFX
+{
+    public:
+        Adafruit_ILI9340(uint8_t cs, uint8_t dc, uint8_t rst);
+        void begin(void);
+        void setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+        void pushColor(uint16_t color);
+        void drawPixel(int16_t x, int16_t y, uint16_t color);
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        void writecommand(uint8_t c);
+        void writedata(uint8_t d);
+};
@@ -0,0 +1,89 @@
+/*!
+ * @file Arduino.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+/*
+ * The part of the Arduino core that the widgets and the benchmark sketches
+ * use, so they build with the PlatformIO native platform. Time comes from
+ * the host clock, Serial writes to stdout and there are no pins.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define F(string_literal) (string_literal)
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Same formatting as the AVR core, so print() costs compare like for like
+class Print
+{
+    private:
+        size_t printNumber(unsigned long n, uint8_t base);
+        size_t printFloat(double number, uint8_t digits);
+
+    public:
+        virtual ~Print(){};
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size);
+        size_t write(const char *str) { return str == NULL ? 0 : write((const uint8_t *)str, strlen(str)); };
+
+        size_t print(const char *str) { return write(str); };
+        size_t print(char c) { return write((uint8_t)c); };
+        size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); };
+        size_t print(int n, int base = DEC) { return print((long)n, base); };
+        size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); };
+        size_t print(long n, int base = DEC);
+        size_t print(unsigned long n, int base = DEC);
+        size_t print(double n, int digits = 2) { return printFloat(n, digits); };
+
+        template <typename T>
+        size_t println(T value) { return print(value) + println(); };
+        template <typename T>
+        size_t println(T value, int format) { return print(value, format) + println(); };
+        size_t println() { return write((const uint8_t *)"\r\n", 2); };
+};
+
+class HardwareSerial : public Print
+{
+    public:
+        void begin(unsigned long){};
+        size_t write(uint8_t c);
+        using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// the sketch
+void setup();
+void loop();
@@ -0,0 +1,12 @@
+/*!
+ * @file SPI.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+// The host has no SPI bus; panels are replaced by TguiFramebuffer
+#include <Arduino.h>
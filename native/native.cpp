@@ -0,0 +1,421 @@
+/*!
+ * @file native.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#define _swap_int16_t(a, b) \
+    {                       \
+        int16_t t = a;      \
+        a = b;              \
+        b = t;              \
+    }
+
+HardwareSerial Serial;
+
+//------------------------ Time -----------------------------------------/
+static uint64_t hostMicros()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static const uint64_t bootMicros = hostMicros();
+
+unsigned long micros()
+{
+    return hostMicros() - bootMicros;
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+// Returns at once: the sketches only wait to pace their serial output
+void delay(unsigned long) {}
+
+void delayMicroseconds(unsigned int) {}
+
+//------------------------ Print ----------------------------------------/
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(long n, int base)
+{
+    if (base == DEC && n < 0)
+    {
+        return print('-') + printNumber(-(unsigned long)n, DEC);
+    }
+    return printNumber(n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+    return printNumber(n, base);
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+    char buf[8 * sizeof(long) + 1];
+    char *str = &buf[sizeof(buf) - 1];
+
+    *str = '\0';
+    if (base < 2)
+    {
+        base = 10;
+    }
+    do
+    {
+        char c = n % base;
+        n /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+
+    return write(str);
+}
+
+size_t Print::printFloat(double number, uint8_t digits)
+{
+    size_t n = 0;
+
+    if (isnan(number))
+    {
+        return print("nan");
+    }
+    if (isinf(number))
+    {
+        return print("inf");
+    }
+    if (number > 4294967040.0 || number < -4294967040.0)
+    {
+        return print("ovf");
+    }
+
+    if (number < 0.0)
+    {
+        n += print('-');
+        number = -number;
+    }
+
+    // round half up at the last printed decimal
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < digits; ++i)
+    {
+        rounding /= 10.0;
+    }
+    number += rounding;
+
+    unsigned long intPart = (unsigned long)number;
+    double remainder = number - (double)intPart;
+    n += print(intPart);
+    if (digits > 0)
+    {
+        n += print('.');
+    }
+    while (digits-- > 0)
+    {
+        remainder *= 10.0;
+        unsigned int toPrint = (unsigned int)remainder;
+        n += print(toPrint);
+        remainder -= toPrint;
+    }
+    return n;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return putchar(c) == EOF ? 0 : 1;
+}
+
+//------------------------ Adafruit_GFX ---------------------------------/
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h)
+{
+    _width = WIDTH;
+    _height = HEIGHT;
+    rotation = 0;
+    cursor_x = cursor_y = 0;
+    textsize_x = textsize_y = 1;
+    textcolor = textbgcolor = 0xFFFF;
+    wrap = true;
+}
+
+void Adafruit_GFX::setRotation(uint8_t r)
+{
+    rotation = (r & 3);
+    if (rotation & 1)
+    {
+        _width = HEIGHT;
+        _height = WIDTH;
+    }
+    else
+    {
+        _width = WIDTH;
+        _height = HEIGHT;
+    }
+}
+
+// Bresenham
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+        _swap_int16_t(x0, y0);
+        _swap_int16_t(x1, y1);
+    }
+    if (x0 > x1)
+    {
+        _swap_int16_t(x0, x1);
+        _swap_int16_t(y0, y1);
+    }
+
+    const int16_t dx = x1 - x0;
+    const int16_t dy = abs(y1 - y0);
+    const int16_t ystep = (y0 < y1) ? 1 : -1;
+    int16_t err = dx / 2;
+    for (; x0 <= x1; x0++)
+    {
+        if (steep)
+        {
+            writePixel(y0, x0, color);
+        }
+        else
+        {
+            writePixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0)
+        {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    startWrite();
+    writeLine(x, y, x, y + h - 1, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    startWrite();
+    writeLine(x, y, x + w - 1, y, color);
+    endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    startWrite();
+    for (int16_t i = x; i < x + w; i++)
+    {
+        writeFastVLine(i, y, h, color);
+    }
+    endWrite();
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+    if (x0 == x1)
+    {
+        if (y0 > y1)
+        {
+            _swap_int16_t(y0, y1);
+        }
+        drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    }
+    else if (y0 == y1)
+    {
+        if (x0 > x1)
+        {
+            _swap_int16_t(x0, x1);
+        }
+        drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    }
+    else
+    {
+        startWrite();
+        writeLine(x0, y0, x1, y1, color);
+        endWrite();
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+}
+
+// corners: 1 top left, 2 top right, 4 bottom right, 8 bottom left
+void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (corners & 0x4)
+        {
+            writePixel(x0 + x, y0 + y, color);
+            writePixel(x0 + y, y0 + x, color);
+        }
+        if (corners & 0x2)
+        {
+            writePixel(x0 + x, y0 - y, color);
+            writePixel(x0 + y, y0 - x, color);
+        }
+        if (corners & 0x8)
+        {
+            writePixel(x0 - y, y0 + x, color);
+            writePixel(x0 - x, y0 + y, color);
+        }
+        if (corners & 0x1)
+        {
+            writePixel(x0 - y, y0 - x, color);
+            writePixel(x0 - x, y0 - y, color);
+        }
+    }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color)
+{
+    const int16_t maxRadius = ((w < h) ? w : h) / 2;
+    if (r > maxRadius)
+    {
+        r = maxRadius;
+    }
+    startWrite();
+    writeFastHLine(x + r, y, w - 2 * r, color);
+    writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    writeFastVLine(x, y + r, h - 2 * r, color);
+    writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+    endWrite();
+}
+
+// Same pixel and fill calls as the classic font, with a solid glyph
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+{
+    if ((x >= _width) || (y >= _height) || ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0))
+    {
+        return;
+    }
+
+    startWrite();
+    for (int8_t i = 0; i < 5; i++)
+    {
+        uint8_t line = (c > ' ') ? 0x7F : 0x00;
+        for (int8_t j = 0; j < 8; j++, line >>= 1)
+        {
+            if (line & 1)
+            {
+                if (size == 1)
+                {
+                    writePixel(x + i, y + j, color);
+                }
+                else
+                {
+                    writeFillRect(x + i * size, y + j * size, size, size, color);
+                }
+            }
+            else if (bg != color)
+            {
+                if (size == 1)
+                {
+                    writePixel(x + i, y + j, bg);
+                }
+                else
+                {
+                    writeFillRect(x + i * size, y + j * size, size, size, bg);
+                }
+            }
+        }
+    }
+    if (bg != color)
+    {
+        if (size == 1)
+        {
+            writeFastVLine(x + 5, y, 8, bg);
+        }
+        else
+        {
+            writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+        }
+    }
+    endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+    if (c == '\n')
+    {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+    }
+    else if (c != '\r')
+    {
+        if (wrap && ((cursor_x + textsize_x * 6) > _width))
+        {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+        cursor_x += textsize_x * 6;
+    }
+    return 1;
+}
+
+//------------------------ Sketch ---------------------------------------/
+// One pass: the benchmark sketches print their whole table from loop()
+int main()
+{
+    setup();
+    loop();
+    fflush(stdout);
+    return 0;
+}
@@ -27,11 +27,40 @@
 
 
 /* Parameters */
-
+#define SENSOR_MAX_LISTENERS 4
 
 /* REGISTERS */
 
 
+/*
+ * One malloc'd array with a single owner. It moves but never copies, so a
+ * widget that is passed around by value cannot end up sharing its buffer.
+ * Reads like a plain pointer and is NULL when empty or out of memory.
+ */
+template <typename T>
+class HeapArray
+{
+private:
+    T *_data;
+
+public:
+    HeapArray() : _data(NULL){};
+    HeapArray(HeapArray &&other) : _data(other._data) { other._data = NULL; };
+    HeapArray(const HeapArray &) = delete;
+    HeapArray &operator=(const HeapArray &) = delete;
+    ~HeapArray() { free(_data); };
+
+    // drops the old array, if any
+    T *allocate(uint16_t count)
+    {
+        free(_data);
+        _data = (T *)malloc(count * sizeof(T));
+        return _data;
+    };
+
+    operator T *() { return _data; };
+};
+
 typedef struct Size
 {
     uint16_t width;
@@ -50,17 +79,84 @@ typedef struct Location
     uint16_t y;
 } Location;
 
+// One channel of a sensor, as the widgets read it
+typedef struct SensorChannel
+{
+    float value;            // filtered
+    float raw;              // latest sample
+    uint16_t generation;    // bumped by every sample
+} SensorChannel;
+
+class Sensor;
+
+// Told by a sensor about every new sample, see Sensor::subscribe()
+class SampleListener
+{
+public:
+    virtual void sampleArrived(Sensor *sensor, uint8_t channel){};
+};
+
 class Sensor
 {
+private:
+    SampleListener *_listeners[SENSOR_MAX_LISTENERS];
+    uint8_t _listenerCount;
+
 protected:
     uint8_t _filterSize;
+    SensorChannel *_channels;
+    uint8_t _channelCount;
     virtual void addDataPoint(uint8_t channel, float data){};
+    // call once a sample is stored and readable
+    void publish(uint8_t channel)
+    {
+        for (uint8_t i = 0; i < _listenerCount; i++)
+        {
+            _listeners[i]->sampleArrived(this, channel);
+        }
+    };
 
 public:
-    Sensor(){};
+    Sensor() : _listenerCount(0), _channels(NULL), _channelCount(0){};
     ~Sensor(){};
     virtual void init(){};
     uint16_t _reportInterval;
     virtual float readDataPoint(uint8_t channel = 0, bool getRawData = false) { return 0; };
     virtual uint16_t getParameters(uint16_t input) { return input; };
+    // the channel table, for walking all channels; empty for sensors without one
+    uint8_t channelCount() { return _channelCount; };
+    const SensorChannel *channel(uint8_t index) { return index < _channelCount ? &_channels[index] : NULL; };
+    uint16_t generation(uint8_t index) { return index < _channelCount ? _channels[index].generation : 0; };
+    // a sensor without a channel table cannot tell, so it always reports a change
+    bool changedSince(uint8_t index, uint16_t generation)
+    {
+        return index >= _channelCount || _channels[index].generation != generation;
+    };
+
+    // false when the list is full; subscribing twice is harmless
+    bool subscribe(SampleListener *listener)
+    {
+        for (uint8_t i = 0; i < _listenerCount; i++)
+        {
+            if (_listeners[i] == listener)
+                return true;
+        }
+        if (_listenerCount == SENSOR_MAX_LISTENERS)
+            return false;
+
+        _listeners[_listenerCount++] = listener;
+        return true;
+    };
+
+    void unsubscribe(SampleListener *listener)
+    {
+        for (uint8_t i = 0; i < _listenerCount; i++)
+        {
+            if (_listeners[i] == listener)
+            {
+                _listeners[i] = _listeners[--_listenerCount];
+                return;
+            }
+        }
+    };
 };
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*!
+ * @file tgui-display.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+#include <tgui-common.h>
+
+#include <SPI.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_ILI9340.h>
+
+/* COMMANDS */
+#define TGUI_VSCRDEF 0x33    // vertical scrolling definition, same on ILI934x and ST7789
+#define TGUI_VSCRSADD 0x37   // vertical scrolling start address
+
+/*
+ * A panel that widgets bind to. Text and shapes go through the Adafruit_GFX
+ * in "screen"; the hot paths use the raw window, run and span primitives,
+ * which a driver maps straight onto its controller. Panels without raw
+ * access keep the defaults and fall back to Adafruit_GFX.
+ */
+class TguiDisplay
+{
+    public:
+        TguiDisplay(Adafruit_GFX *gfx) : screen(gfx){};
+        virtual void begin(){};
+        // open an address window, pixels then fill it row by row
+        virtual bool setWindow(int16_t x, int16_t y, int16_t w, int16_t h) { return false; };
+        virtual void pushRun(uint16_t color, uint16_t count){};
+        virtual void endWindow(){};
+        virtual void fillSpan(int16_t x, int16_t y, int16_t w, uint16_t color) { screen->drawFastHLine(x, y, w, color); };
+        // hardware scrolling along the panel's long axis: the lines of frame
+        // memory on that axis, 0 for a panel that cannot scroll
+        virtual uint16_t scrollLines() { return 0; };
+        bool canScroll() { return scrollLines() != 0; };
+        virtual void defineScrollArea(uint16_t top, uint16_t height, uint16_t bottom){};
+        virtual void scrollTo(uint16_t line){};
+        Adafruit_GFX *screen;
+};
+
+// The original Adafruit_ILI9340 board, driven through its own pins
+class TguiILI9340 : public TguiDisplay
+{
+    public:
+        TguiILI9340(uint8_t cs, uint8_t dc, uint8_t rst) : TguiDisplay(&panel), panel(cs, dc, rst){};
+        TguiILI9340(const TguiILI9340 &other) : TguiDisplay(&panel), panel(other.panel){};
+
+        void begin() { panel.begin(); };
+
+        bool setWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+        {
+            panel.setAddrWindow(x, y, x + w - 1, y + h - 1);
+            return true;
+        };
+
+        void pushRun(uint16_t color, uint16_t count)
+        {
+            while (count--)
+            {
+                panel.pushColor(color);
+            }
+        };
+
+        void fillSpan(int16_t x, int16_t y, int16_t w, uint16_t color) { panel.drawFastHLine(x, y, w, color); };
+
+        uint16_t scrollLines() { return ILI9340_TFTHEIGHT; };
+
+        void defineScrollArea(uint16_t top, uint16_t height, uint16_t bottom)
+        {
+            panel.writecommand(TGUI_VSCRDEF);
+            panel.writedata(top >> 8);
+            panel.writedata(top);
+            panel.writedata(height >> 8);
+            panel.writedata(height);
+            panel.writedata(bottom >> 8);
+            panel.writedata(bottom);
+        };
+
+        void scrollTo(uint16_t line)
+        {
+            panel.writecommand(TGUI_VSCRSADD);
+            panel.writedata(line >> 8);
+            panel.writedata(line);
+        };
+
+        Adafruit_ILI9340 panel;
+};
+
+/*
+ * Any panel built on Adafruit_SPITFT, such as Adafruit_ILI9341 or
+ * Adafruit_ST7789. The sketch owns the panel and starts it with the
+ * controller's own begin() or init(), at the SPI clock it can take.
+ * A window holds the SPI transaction open until endWindow(), and a run is
+ * one writeColor() burst instead of a call per pixel.
+ * Hardware scrolling is opt-in: pass the controller's frame memory lines
+ * along the long axis, 320 for ILI9341, when the panel shows all of them.
+ * Panels that map a window of a larger memory, such as a 240x240 ST7789,
+ * keep the default of 0 and do not scroll.
+ */
+template <typename Panel>
+class TguiSPITFT : public TguiDisplay
+{
+    public:
+        TguiSPITFT(Panel *tft, uint16_t scrollLines = 0) : TguiDisplay(tft), panel(tft), _scrollLines(scrollLines){};
+
+        bool setWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+        {
+            panel->startWrite();
+            panel->setAddrWindow(x, y, w, h);
+            return true;
+        };
+
+        void pushRun(uint16_t color, uint16_t count) { panel->writeColor(color, count); };
+
+        void endWindow() { panel->endWrite(); };
+
+        void fillSpan(int16_t x, int16_t y, int16_t w, uint16_t color) { panel->drawFastHLine(x, y, w, color); };
+
+        uint16_t scrollLines() { return _scrollLines; };
+
+        void defineScrollArea(uint16_t top, uint16_t height, uint16_t bottom)
+        {
+            const uint8_t data[] = {
+                (uint8_t)(top >> 8), (uint8_t)top,
+                (uint8_t)(height >> 8), (uint8_t)height,
+                (uint8_t)(bottom >> 8), (uint8_t)bottom};
+            panel->sendCommand(TGUI_VSCRDEF, data, sizeof(data));
+        };
+
+        void scrollTo(uint16_t line)
+        {
+            const uint8_t data[] = {(uint8_t)(line >> 8), (uint8_t)line};
+            panel->sendCommand(TGUI_VSCRSADD, data, sizeof(data));
+        };
+
+        Panel *panel;
+
+    private:
+        uint16_t _scrollLines;
+};
@@ -0,0 +1,342 @@
+/*!
+ * @file tgui-filter.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+#include <tgui-common.h>
+
+/*
+ * Filter stages for sensor channels. Every stage has the same shape:
+ *   float add(float sample)   consume a sample, return the new output
+ *   float value()             the last output
+ *   void clear()              forget all samples
+ *   float groupDelay()        lag of the output in samples, for a slow signal
+ * Stages compose with FilterChain, which calls them directly, so a chain
+ * costs no virtual calls and no heap.
+ */
+
+class PassThrough
+{
+    private:
+        float _value;
+
+    public:
+        PassThrough() : _value(NAN){};
+        float add(float sample) { return _value = sample; };
+        float value() { return _value; };
+        void clear() { _value = NAN; };
+        float groupDelay() { return 0; };
+};
+
+/*
+ * Median filter over the last N samples, statically sized. The window is
+ * kept sorted as samples arrive, so add() costs O(N) and the median and the
+ * trimmed mean of the Middle central samples are read in O(1).
+ * The sort order is stored as ring slots, one byte per sample.
+ */
+template <uint8_t N, uint8_t Middle = N / 2 + 1>
+class MedianFilter
+{
+    private:
+        float _ring[N];     // samples in arrival order
+        uint8_t _order[N];  // ring slots sorted by value
+        uint8_t _head;      // slot of the next sample, the oldest one once full
+        uint8_t _count;
+        float _average;
+
+        static_assert(N > 0 && Middle > 0 && Middle <= N, "invalid median window");
+
+        void updateAverage()
+        {
+            const uint8_t middle = _count < Middle ? _count : Middle;
+            const uint8_t first = (_count - middle) / 2;
+            float sum = 0;
+            for (uint8_t i = first; i < first + middle; i++)
+            {
+                sum += _ring[_order[i]];
+            }
+            _average = sum / middle;
+        };
+
+    public:
+        MedianFilter() : _head(0), _count(0), _average(NAN){};
+
+        float add(float value)
+        {
+            uint8_t position = _count;
+            if (_count == N)
+            {
+                // take the oldest sample out of the sort order
+                position = 0;
+                while (_order[position] != _head)
+                {
+                    position++;
+                }
+                for (; position < N - 1; position++)
+                {
+                    _order[position] = _order[position + 1];
+                }
+            }
+            else
+            {
+                _count++;
+            }
+
+            // insertion step, the tail is already sorted
+            while (position > 0 && _ring[_order[position - 1]] > value)
+            {
+                _order[position] = _order[position - 1];
+                position--;
+            }
+            _order[position] = _head;
+            _ring[_head] = value;
+            _head = (_head + 1 == N) ? 0 : _head + 1;
+
+            updateAverage();
+            return _average;
+        };
+
+        void clear()
+        {
+            _head = 0;
+            _count = 0;
+            _average = NAN;
+        };
+
+        float median() { return _count ? _ring[_order[_count / 2]] : NAN; };
+        float average() { return _average; };
+        float value() { return _average; };
+        float groupDelay() { return (N - 1) / 2.0; };
+        float latest() { return _count ? _ring[_head ? _head - 1 : N - 1] : NAN; };
+        uint8_t count() { return _count; };
+        uint8_t size() { return N; };
+};
+
+// Exponential moving average with a weight of 1 / 2^Shift for new samples
+template <uint8_t Shift>
+class EmaFilter
+{
+    private:
+        static constexpr float weight = 1.0 / (1UL << Shift);
+        float _value;
+
+        static_assert(Shift < 16, "EMA shift too large");
+
+    public:
+        EmaFilter() : _value(NAN){};
+
+        float add(float sample)
+        {
+            if (isnan(_value))
+                return _value = sample;
+
+            return _value += (sample - _value) * weight;
+        };
+
+        float value() { return _value; };
+        void clear() { _value = NAN; };
+        float groupDelay() { return (1UL << Shift) - 1; };
+};
+
+// Plain average of the last N samples, updated with a running sum
+template <uint8_t N>
+class MovingAverage
+{
+    private:
+        float _ring[N];
+        float _sum;
+        uint8_t _head;
+        uint8_t _count;
+
+        static_assert(N > 0, "empty moving average window");
+
+    public:
+        MovingAverage() : _sum(0), _head(0), _count(0){};
+
+        float add(float sample)
+        {
+            if (_count == N)
+            {
+                _sum -= _ring[_head];
+            }
+            else
+            {
+                _count++;
+            }
+            _ring[_head] = sample;
+            _sum += sample;
+
+            if (++_head == N)
+            {
+                // resum once per window so rounding errors cannot pile up
+                _head = 0;
+                _sum = 0;
+                for (uint8_t i = 0; i < _count; i++)
+                {
+                    _sum += _ring[i];
+                }
+            }
+            return value();
+        };
+
+        float value() { return _count ? _sum / _count : NAN; };
+        void clear() { _sum = 0; _head = 0; _count = 0; };
+        float groupDelay() { return (N - 1) / 2.0; };
+};
+
+/*
+ * Scalar Kalman filter for a slowly wandering value. ProcessNoise and
+ * MeasurementNoise are variances in thousandths of the squared sensor unit.
+ * A larger measurement noise smooths more and lags more.
+ */
+template <uint16_t ProcessNoise, uint16_t MeasurementNoise>
+class Kalman1D
+{
+    private:
+        static constexpr float q = ProcessNoise / 1000.0;
+        static constexpr float r = MeasurementNoise / 1000.0;
+        float _value;
+        float _variance;
+
+        static_assert(ProcessNoise > 0 && MeasurementNoise > 0, "noise variances must be positive");
+
+    public:
+        Kalman1D() : _value(NAN), _variance(0){};
+
+        float add(float sample)
+        {
+            if (isnan(_value))
+            {
+                _variance = r;
+                return _value = sample;
+            }
+
+            _variance += q;
+            const float gain = _variance / (_variance + r);
+            _value += gain * (sample - _value);
+            _variance *= 1 - gain;
+            return _value;
+        };
+
+        float value() { return _value; };
+        void clear() { _value = NAN; _variance = 0; };
+
+        // from the steady-state gain, which the filter settles to after a few samples
+        float groupDelay()
+        {
+            const float predicted = (q + sqrt(q * q + 4 * q * r)) / 2;
+            const float gain = predicted / (predicted + r);
+            return (1 - gain) / gain;
+        };
+};
+
+/*
+ * Stages applied in order, each one feeding the next. The output and the
+ * group delay are those of the whole chain.
+ */
+template <typename... Stages>
+class FilterChain;
+
+template <typename Last>
+class FilterChain<Last>
+{
+    private:
+        Last _stage;
+
+    public:
+        float add(float sample) { return _stage.add(sample); };
+        float value() { return _stage.value(); };
+        void clear() { _stage.clear(); };
+        float groupDelay() { return _stage.groupDelay(); };
+};
+
+template <typename First, typename... Rest>
+class FilterChain<First, Rest...>
+{
+    private:
+        First _stage;
+        FilterChain<Rest...> _rest;
+
+    public:
+        float add(float sample) { return _rest.add(_stage.add(sample)); };
+        float value() { return _rest.value(); };
+        void clear()
+        {
+            _stage.clear();
+            _rest.clear();
+        };
+        float groupDelay() { return _stage.groupDelay() + _rest.groupDelay(); };
+};
+
+/*
+ * One filter per channel, each of its own type. The channel is a runtime
+ * index for add() and groupDelay(), or a template argument for get<>().
+ */
+template <typename... Filters>
+class FilterBank;
+
+template <>
+class FilterBank<>
+{
+    public:
+        float add(uint8_t index, float sample) { return NAN; };
+        void clear(){};
+        float groupDelay(uint8_t index) { return NAN; };
+};
+
+template <uint8_t Index, typename Bank>
+struct FilterBankSlot
+{
+    typedef FilterBankSlot<Index - 1, typename Bank::Tail> Next;
+    typedef typename Next::Filter Filter;
+    static Filter &get(Bank &bank) { return Next::get(bank.tail()); };
+};
+
+template <typename Bank>
+struct FilterBankSlot<0, Bank>
+{
+    typedef typename Bank::Head Filter;
+    static Filter &get(Bank &bank) { return bank.head(); };
+};
+
+template <typename First, typename... Rest>
+class FilterBank<First, Rest...> : public FilterBank<Rest...>
+{
+    private:
+        First _filter;
+
+    public:
+        typedef First Head;
+        typedef FilterBank<Rest...> Tail;
+
+        float add(uint8_t index, float sample)
+        {
+            return index == 0 ? _filter.add(sample) : Tail::add(index - 1, sample);
+        };
+
+        void clear()
+        {
+            _filter.clear();
+            Tail::clear();
+        };
+
+        float groupDelay(uint8_t index)
+        {
+            return index == 0 ? _filter.groupDelay() : Tail::groupDelay(index - 1);
+        };
+
+        First &head() { return _filter; };
+        Tail &tail() { return *this; };
+
+        template <uint8_t Index>
+        typename FilterBankSlot<Index, FilterBank>::Filter &get()
+        {
+            static_assert(Index <= sizeof...(Rest), "no such channel");
+            return FilterBankSlot<Index, FilterBank>::get(*this);
+        };
+};
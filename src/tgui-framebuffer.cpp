@@ -0,0 +1,194 @@
+/*!
+ * @file tgui-framebuffer.cpp
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+
+#include "tgui-framebuffer.h"
+
+#ifndef __AVR__
+#include <stdio.h>
+#endif
+
+TguiFramebuffer::TguiFramebuffer(int16_t w, int16_t h) : Adafruit_GFX(w, h), TguiDisplay(this)
+{
+    // a full 320x240 buffer does not even fit in a 16-bit size_t, so the
+    // pixel count is checked before it is multiplied into bytes
+    const bool fits = w > 0 && h > 0 && (size_t)h <= SIZE_MAX / sizeof(uint16_t) / w;
+    const size_t bytes = fits ? (size_t)w * h * sizeof(uint16_t) : 0;
+    _buffer = fits ? (uint16_t *)malloc(bytes) : NULL;
+    if (_buffer != NULL)
+    {
+        memset(_buffer, 0, bytes);
+    }
+
+    _windowX0 = _windowY0 = _windowX1 = _windowY1 = 0;
+    _cursorX = _cursorY = 0;
+    resetStats();
+}
+
+TguiFramebuffer::~TguiFramebuffer()
+{
+    free(_buffer);
+}
+
+void TguiFramebuffer::store(int16_t x, int16_t y, uint16_t color)
+{
+    if (_buffer == NULL || x < 0 || y < 0 || x >= _width || y >= _height)
+        return;
+
+    _buffer[(uint32_t)y * _width + x] = color;
+}
+
+void TguiFramebuffer::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return;
+
+    _stats.windows++;
+    _stats.pixels++;
+    store(x, y, color);
+}
+
+void TguiFramebuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+void TguiFramebuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void TguiFramebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    // clip like the panel driver does, nothing is sent for an empty rectangle
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > _width)
+        w = _width - x;
+    if (y + h > _height)
+        h = _height - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    _stats.fills++;
+    _stats.windows++;
+    _stats.pixels += (uint32_t)w * h;
+
+    if (_buffer == NULL)
+        return;
+
+    for (int16_t row = y; row < y + h; row++)
+    {
+        uint16_t *pixel = &_buffer[(uint32_t)row * _width + x];
+        for (int16_t i = 0; i < w; i++)
+        {
+            *pixel++ = color;
+        }
+    }
+}
+
+void TguiFramebuffer::setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    _windowX0 = _cursorX = x0;
+    _windowY0 = _cursorY = y0;
+    _windowX1 = x1;
+    _windowY1 = y1;
+    _stats.windows++;
+}
+
+// Pixels fill the window row by row and wrap to its top, as on the panel
+void TguiFramebuffer::pushColor(uint16_t color)
+{
+    _stats.pixels++;
+    store(_cursorX, _cursorY, color);
+
+    if (++_cursorX > _windowX1)
+    {
+        _cursorX = _windowX0;
+        if (++_cursorY > _windowY1)
+        {
+            _cursorY = _windowY0;
+        }
+    }
+}
+
+bool TguiFramebuffer::setWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    setAddrWindow(x, y, x + w - 1, y + h - 1);
+    return true;
+}
+
+void TguiFramebuffer::pushRun(uint16_t color, uint16_t count)
+{
+    while (count--)
+    {
+        pushColor(color);
+    }
+}
+
+uint16_t TguiFramebuffer::getPixel(int16_t x, int16_t y)
+{
+    if (_buffer == NULL || x < 0 || y < 0 || x >= _width || y >= _height)
+        return 0;
+
+    return _buffer[(uint32_t)y * _width + x];
+}
+
+void TguiFramebuffer::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// Cost of one widget update, including the fills its compositor defers
+FramebufferStats TguiFramebuffer::measure(TguiElement *widget)
+{
+    resetStats();
+    widget->update();
+    if (widget->compositor != NULL)
+    {
+        widget->compositor->flush();
+    }
+    return _stats;
+}
+
+#ifndef __AVR__
+// Binary PPM, RGB565 expanded to 8 bits per channel
+bool TguiFramebuffer::writePPM(const char *path)
+{
+    if (_buffer == NULL)
+        return false;
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", _width, _height);
+    const uint32_t count = (uint32_t)_width * _height;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint16_t color = _buffer[i];
+        const uint8_t r = (color >> 11) & 0x1F;
+        const uint8_t g = (color >> 5) & 0x3F;
+        const uint8_t b = color & 0x1F;
+        const uint8_t rgb[3] = {
+            (uint8_t)((r << 3) | (r >> 2)),
+            (uint8_t)((g << 2) | (g >> 4)),
+            (uint8_t)((b << 3) | (b >> 2))};
+        fwrite(rgb, 1, 3, file);
+    }
+    return fclose(file) == 0;
+}
+#endif
@@ -0,0 +1,62 @@
+/*!
+ * @file tgui-framebuffer.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+#include <tgui.h>
+
+typedef struct FramebufferStats
+{
+    uint32_t pixels;    // pixels sent to the panel, overdraw included
+    uint16_t fills;     // fillRect and fast line calls
+    uint16_t windows;   // address-window commands the panel would receive
+} FramebufferStats;
+
+/*
+ * A headless RGB565 panel. Every primitive is counted the way the ILI9340
+ * driver would send it, so the cost of a widget change can be measured
+ * without hardware. When the pixel memory cannot be allocated, as on an Uno,
+ * the framebuffer still counts but stores nothing.
+ * It is its own display driver, so widgets bind to it like to a panel.
+ */
+class TguiFramebuffer : public Adafruit_GFX, public TguiDisplay
+{
+    private:
+        uint16_t *_buffer;
+        int16_t _windowX0;
+        int16_t _windowY0;
+        int16_t _windowX1;
+        int16_t _windowY1;
+        int16_t _cursorX;
+        int16_t _cursorY;
+        FramebufferStats _stats;
+        void store(int16_t x, int16_t y, uint16_t color);
+
+    public:
+        TguiFramebuffer(int16_t w, int16_t h);
+        TguiFramebuffer(const TguiFramebuffer &) = delete;   // owns its pixel memory
+        ~TguiFramebuffer();
+
+        void drawPixel(int16_t x, int16_t y, uint16_t color);
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        void setAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+        void pushColor(uint16_t color);
+        bool setWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+        void pushRun(uint16_t color, uint16_t count);
+
+        uint16_t getPixel(int16_t x, int16_t y);
+        bool hasPixels() { return _buffer != NULL; };
+        const FramebufferStats *stats() { return &_stats; };
+        void resetStats();
+        FramebufferStats measure(TguiElement *widget);
+#ifndef __AVR__
+        bool writePPM(const char *path);
+#endif
+};
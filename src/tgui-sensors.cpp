@@ -13,215 +13,366 @@
 #define SEALEVELPRESSURE_HPA (1013.25)
 #define DATA_READY 17 //PD2(INT0) on Odroid
 
+/* REGISTERS */
+#define BME280_REG_CTRL_MEAS 0xF4
+#define BME280_REG_DATA 0xF7    // press_msb, 8 bytes up to hum_lsb
+#define BME280_DATA_SIZE 8
+
 //------------------------- BME280 -------------------------------------/
-void SensorBME280::init()
+void SensorBME280Device::init()
 {
     bool status = _phy.begin(_address);
     if (!status)
         Sprintln(F("No BME280 sensor"));
+    applyProfile();
 }
 
-void SensorBME280::addDataPoint(uint8_t channel, float data)
+// Can be changed after init(), the new profile takes effect right away
+void SensorBME280Device::setProfile(uint8_t profile)
 {
-    RunningMedian *filter;
-    switch (channel)
+    _profile = profile;
+    if (_ctrlMeas != 0)
+        applyProfile();
+}
+
+// Worst case time of one conversion in ms, datasheet section 9.1.
+// Oversampling settings count samples as 1 << (setting - 1), 0 skips the channel.
+static uint8_t conversionTime(uint8_t osrsT, uint8_t osrsP, uint8_t osrsH)
+{
+    uint32_t us = 1250;
+    if (osrsT)
+        us += 2300UL << (osrsT - 1);
+    if (osrsP)
+        us += (2300UL << (osrsP - 1)) + 575;
+    if (osrsH)
+        us += (2300UL << (osrsH - 1)) + 575;
+    return (us + 999) / 1000;
+}
+
+// The longest standby that still gives a fresh sample every report interval
+static Adafruit_BME280::standby_duration standbyFor(uint16_t interval, uint8_t measurement)
+{
+    static const uint16_t halfMs[] = {2000, 1000, 500, 250, 125, 40, 20};
+    static const Adafruit_BME280::standby_duration settings[] = {
+        Adafruit_BME280::STANDBY_MS_1000,
+        Adafruit_BME280::STANDBY_MS_500,
+        Adafruit_BME280::STANDBY_MS_250,
+        Adafruit_BME280::STANDBY_MS_125,
+        Adafruit_BME280::STANDBY_MS_62_5,
+        Adafruit_BME280::STANDBY_MS_20,
+        Adafruit_BME280::STANDBY_MS_10};
+
+    for (uint8_t i = 0; i < sizeof(halfMs) / sizeof(halfMs[0]); i++)
     {
-    case BME280_TEMPERATURE:
-        filter = &_filterTemperature;
-        break;
-    case BME280_HUMIDITY:
-        filter = &_filterHumidity;
+        if (2UL * measurement + halfMs[i] <= 2UL * interval)
+            return settings[i];
+    }
+    return Adafruit_BME280::STANDBY_MS_0_5;
+}
+
+void SensorBME280Device::applyProfile()
+{
+    Adafruit_BME280::sensor_mode mode = Adafruit_BME280::MODE_NORMAL;
+    Adafruit_BME280::sensor_sampling osrsT = Adafruit_BME280::SAMPLING_X16;
+    Adafruit_BME280::sensor_sampling osrsP = Adafruit_BME280::SAMPLING_X16;
+    Adafruit_BME280::sensor_sampling osrsH = Adafruit_BME280::SAMPLING_X16;
+    Adafruit_BME280::sensor_filter filter = Adafruit_BME280::FILTER_OFF;
+
+    switch (_profile)
+    {
+    case WEATHER_STATION:
+        mode = Adafruit_BME280::MODE_FORCED;
+        osrsT = osrsP = osrsH = Adafruit_BME280::SAMPLING_X1;
         break;
-    case BME280_PRESSURE:
-        filter = &_filter;
+    case INDOOR:
+        osrsT = Adafruit_BME280::SAMPLING_X2;
+        osrsH = Adafruit_BME280::SAMPLING_X1;
+        filter = Adafruit_BME280::FILTER_X16;
         break;
-    case BME280_ALTITUDE:
-        filter = &_filterAltitude;
+    case HIGH_RATE:
+        osrsT = Adafruit_BME280::SAMPLING_X1;
+        osrsP = Adafruit_BME280::SAMPLING_X4;
+        osrsH = Adafruit_BME280::SAMPLING_X1;
+        filter = Adafruit_BME280::FILTER_X4;
         break;
 
     default:
-        filter = &_filter;
         break;
     }
-    filter->add(data);
+
+    _measurementTime = conversionTime(osrsT, osrsP, osrsH);
+    const Adafruit_BME280::standby_duration standby = (_profile == INDOOR) ?
+        standbyFor(_reportInterval, _measurementTime) : Adafruit_BME280::STANDBY_MS_0_5;
+    _ctrlMeas = (osrsT << 5) | (osrsP << 2) | mode;
+
+    // in forced mode this starts the first conversion
+    _phy.setSampling(mode, osrsT, osrsP, osrsH, filter, standby);
+    _forced = (mode == Adafruit_BME280::MODE_FORCED);
+    _conversionStart = millis();
 }
 
-float SensorBME280::readDataPoint(uint8_t channel = 0, bool getRawData = false)
+/*
+ * Compensation as in the BME280 datasheet, section 4.2.3 and 8.2. The
+ * pressure uses the 32-bit formula, good to 1 Pa without 64-bit math.
+ * Returns false if the read failed; a skipped channel comes back as NAN.
+ */
+bool BME280Burst::readAll(uint8_t address, float *temperature, float *pressure, float *humidity)
 {
-    RunningMedian *filter;
-    switch (channel)
+    uint8_t data[BME280_DATA_SIZE];
+
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)BME280_REG_DATA);
+    if (Wire.endTransmission() != 0)
+        return false;
+
+    if (Wire.requestFrom(address, (uint8_t)BME280_DATA_SIZE) != BME280_DATA_SIZE)
+        return false;
+    for (uint8_t i = 0; i < BME280_DATA_SIZE; i++)
     {
-    case BME280_TEMPERATURE:
-        filter = &_filterTemperature;
-        break;
-    case BME280_HUMIDITY:
-        filter = &_filterHumidity;
-        break;
-    case BME280_PRESSURE:
-        filter = &_filter;
-        break;
-    case BME280_ALTITUDE:
-        filter = &_filterAltitude;
-        break;
+        data[i] = Wire.read();
+    }
 
-    default:
-        filter = &_filter;
-        break;
+    const int32_t adcP = ((uint32_t)data[0] << 12) | ((uint32_t)data[1] << 4) | (data[2] >> 4);
+    const int32_t adcT = ((uint32_t)data[3] << 12) | ((uint32_t)data[4] << 4) | (data[5] >> 4);
+    const int32_t adcH = ((uint32_t)data[6] << 8) | data[7];
+    const bme280_calib_data *c = &_bme280_calib;
+
+    // temperature, which every other channel needs through t_fine
+    if (adcT == 0x80000)
+    {
+        *temperature = *pressure = *humidity = NAN;
+        return true;
     }
-    
-    if (getRawData)
+    int32_t var1 = ((((adcT >> 3) - ((int32_t)c->dig_T1 << 1))) * ((int32_t)c->dig_T2)) >> 11;
+    int32_t var2 = (((((adcT >> 4) - ((int32_t)c->dig_T1)) * ((adcT >> 4) - ((int32_t)c->dig_T1))) >> 12) *
+                    ((int32_t)c->dig_T3)) >> 14;
+    t_fine = var1 + var2;
+    *temperature = ((t_fine * 5 + 128) >> 8) / 100.0;
+
+    // pressure in Pa
+    *pressure = NAN;
+    var1 = (t_fine >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)c->dig_P6);
+    var2 = var2 + ((var1 * ((int32_t)c->dig_P5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)c->dig_P4) << 16);
+    var1 = (((c->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)c->dig_P2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)c->dig_P1)) >> 15);
+    if (adcP != 0x80000 && var1 != 0)
     {
-        return filter->getElement(filter->getSize() - 1);
+        uint32_t p = (((uint32_t)(((int32_t)1048576) - adcP) - (var2 >> 12))) * 3125;
+        if (p < 0x80000000)
+        {
+            p = (p << 1) / ((uint32_t)var1);
+        }
+        else
+        {
+            p = (p / (uint32_t)var1) * 2;
+        }
+        var1 = (((int32_t)c->dig_P9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+        var2 = (((int32_t)(p >> 2)) * ((int32_t)c->dig_P8)) >> 13;
+        *pressure = (uint32_t)((int32_t)p + ((var1 + var2 + c->dig_P7) >> 4));
     }
-    else
+
+    // humidity in %RH, from a Q22.10 result
+    *humidity = NAN;
+    if (adcH != 0x8000)
     {
-        return filter->getAverage(_filterSize);
+        int32_t h = t_fine - (int32_t)76800;
+        h = (((((adcH << 14) - (((int32_t)c->dig_H4) << 20) - (((int32_t)c->dig_H5) * h)) + (int32_t)16384) >> 15) *
+             (((((((h * ((int32_t)c->dig_H6)) >> 10) * (((h * ((int32_t)c->dig_H3)) >> 11) + (int32_t)32768)) >> 10) +
+                (int32_t)2097152) * ((int32_t)c->dig_H2) + 8192) >> 14));
+        h = h - (((((h >> 15) * (h >> 15)) >> 7) * ((int32_t)c->dig_H1)) >> 4);
+        h = h < 0 ? 0 : h;
+        h = h > 419430400 ? 419430400 : h;
+        *humidity = (h >> 12) / 1024.0;
     }
+    return true;
 }
 
-void SensorBME280::updateTemperature()
+bool BME280Burst::startForced(uint8_t address, uint8_t ctrlMeas)
+{
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)BME280_REG_CTRL_MEAS);
+    Wire.write(ctrlMeas);
+    return Wire.endTransmission() == 0;
+}
+
+// usually the pressure stays between 980 and 1030hpa
+// Record in Sweden shows the upper and lower bounds are 938.4 and 1063.7hpa
+static float pressureChannel(float pascal)
+{
+    return (pascal - 98000.0) / 1000.0;
+}
+
+// Same formula as Adafruit_BME280::readAltitude()
+static float altitudeOf(float pascal)
+{
+    return 44330.0 * (1.0 - pow(pascal / 100.0 / SEALEVELPRESSURE_HPA, 0.1903));
+}
+
+// In forced mode every call harvests the conversion started by the previous
+// one and starts the next, so the sensor sleeps between report intervals
+bool SensorBME280Device::updateAll()
+{
+    if (!dataReady())
+        return false;
+
+    float temperature, pressure, humidity;
+    const bool read = _phy.readAll(_address, &temperature, &pressure, &humidity);
+
+    if (_forced)
+    {
+        _phy.startForced(_address, _ctrlMeas);
+        _conversionStart = millis();
+    }
+    if (!read)
+        return false;
+
+    addDataPoint(BME280_TEMPERATURE, temperature);
+    addDataPoint(BME280_HUMIDITY, humidity);
+    addDataPoint(BME280_PRESSURE, pressureChannel(pressure));
+    addDataPoint(BME280_ALTITUDE, altitudeOf(pressure));
+    return true;
+}
+
+
+void SensorBME280Device::updateTemperature()
 {
     addDataPoint(BME280_TEMPERATURE, _phy.readTemperature());
 }
 
-void SensorBME280::updateHumidity()
+void SensorBME280Device::updateHumidity()
 {
     addDataPoint(BME280_HUMIDITY, _phy.readHumidity());
 }
 
-void SensorBME280::updatePressure()
+void SensorBME280Device::updatePressure()
 {
-    // usually the pressure stays between 980 and 1030hpa
-    // Record in Sweden shows the upper and lower bounds are 938.4 and 1063.7hpa
-    addDataPoint(BME280_PRESSURE, (_phy.readPressure()-98000.0)/1000.0);
+    addDataPoint(BME280_PRESSURE, pressureChannel(_phy.readPressure()));
 }
 
-void SensorBME280::updateAltitude()
+void SensorBME280Device::updateAltitude()
 {
     addDataPoint(BME280_ALTITUDE, _phy.readAltitude(SEALEVELPRESSURE_HPA));
 }
 
 //------------------------ VL53L0X ---------------------------------------/
-#define LONG_RANGE
-//#define HIGH_SPEED
-#define HIGH_ACCURACY
-
-void SensorVL53L0X::init()
+void SensorVL53L0XDevice::init()
 {
+    if (_interruptPin != VL53L0X_NO_INTERRUPT_PIN)
+        pinMode(_interruptPin, INPUT_PULLUP);   // GPIO1, low while a range waits
+
     _phy.init();
     _phy.setTimeout(200);
-
-#if defined LONG_RANGE
-    // lower the return signal rate limit (default is 0.25 MCPS)
-    _phy.setSignalRateLimit(0.1);
-    // increase laser pulse periods (defaults are 14 and 10 PCLKs)
-    _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodPreRange, 18);
-    _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodFinalRange, 14);
-#endif
-#if defined HIGH_SPEED
-    // reduce timing budget to 20 ms (default is about 33 ms)
-    _phy.setMeasurementTimingBudget(20000);
-#elif defined HIGH_ACCURACY
-    // increase timing budget to 100 ms
-    _phy.setMeasurementTimingBudget(100000);
-#endif
+    applyProfile();
+    _running = true;
     Sprintln("VL53L0X initialized");
 }
 
-void SensorVL53L0X::addDataPoint(uint8_t channel, float data)
+// Can be changed while ranging, the sensor is stopped and started again
+void SensorVL53L0XDevice::setProfile(uint8_t profile)
 {
-    RunningMedian *filter = &_filter;
-    filter->add(data);
+    _profile = profile;
+    if (_running)
+        applyProfile();
 }
 
-float SensorVL53L0X::readDataPoint(uint8_t channel = 0, bool getRawData = false)
+void SensorVL53L0XDevice::applyProfile()
 {
-    RunningMedian *filter = &_filter;
+    if (_running)
+        _phy.stopContinuous();
 
-    if (getRawData)
+    if (_profile & LONG_RANGE)
     {
-        return filter->getElement(filter->getSize() - 1);
+        // lower the return signal rate limit (default is 0.25 MCPS)
+        _phy.setSignalRateLimit(0.1);
+        // increase laser pulse periods (defaults are 14 and 10 PCLKs)
+        _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodPreRange, 18);
+        _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodFinalRange, 14);
     }
     else
     {
-        return filter->getAverage(_filterSize);
+        _phy.setSignalRateLimit(0.25);
+        _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodPreRange, 14);
+        _phy.setVcselPulsePeriod(VL53L0X::VcselPeriodFinalRange, 10);
     }
-}
 
-void SensorVL53L0X::updateData()
-{
-    addDataPoint(0, _phy.readRangeSingleMillimeters());
-}
+    if (_profile & HIGH_SPEED)
+    {
+        // reduce timing budget to 20 ms (default is about 33 ms)
+        _phy.setMeasurementTimingBudget(20000);
+    }
+    else if (_profile & HIGH_ACCURACY)
+    {
+        // increase timing budget to 100 ms
+        _phy.setMeasurementTimingBudget(100000);
+    }
+    else
+    {
+        _phy.setMeasurementTimingBudget(33000);
+    }
 
-//------------------------ Si1132 ---------------------------------------/
-void SensorSi1132::init()
-{
-    _phy.begin();
+    // back to back, a new range every timing budget
+    _phy.startContinuous(0);
 }
 
-void SensorSi1132::addDataPoint(uint8_t channel, float data)
+// Takes the range if one is ready, never waits for the sensor
+bool SensorVL53L0XDevice::updateData()
 {
-    RunningMedian *filter;
-    switch (channel)
+    if (_interruptPin != VL53L0X_NO_INTERRUPT_PIN)
     {
-    case SI1132_VISIBLE:
-        filter = &_filter;
-        break;
-    case SI1132_IR:
-        filter = &_filterIR;
-        break;
-    case SI1132_UV:
-        filter = &_filterUV;
-        break;
-
-    default:
-        filter = &_filter;
-        break;
+        if (digitalRead(_interruptPin) != LOW)
+            return false;
+    }
+    else if ((_phy.readReg(VL53L0X::RESULT_INTERRUPT_STATUS) & 0x07) == 0)
+    {
+        return false;
     }
-    filter->add(data);
+
+    // the range sits 10 bytes into the result block
+    const uint16_t range = _phy.readReg16Bit(VL53L0X::RESULT_RANGE_STATUS + 10);
+    _phy.writeReg(VL53L0X::SYSTEM_INTERRUPT_CLEAR, 0x01);
+    addDataPoint(VL53L0X_DISTANCE, range);
+    return true;
 }
 
-float SensorSi1132::readDataPoint(uint8_t channel = 0, bool getRawData = false)
+//------------------------ Si1132 ---------------------------------------/
+void SensorSi1132Device::init()
 {
-    RunningMedian *filter;
-    switch (channel)
-    {
-    case SI1132_VISIBLE:
-        filter = &_filter;
-        break;
-    case SI1132_IR:
-        filter = &_filterIR;
-        break;
-    case SI1132_UV:
-        filter = &_filterUV;
-        break;
-
-    default:
-        filter = &_filter;
-        break;
-    }
+    if (_interruptPin != SI1132_NO_INTERRUPT_PIN)
+        pinMode(_interruptPin, INPUT_PULLUP);   // open drain, low while a sample waits
+    _phy.begin();
+}
 
-    if (getRawData)
-    {
-        return filter->getElement(filter->getSize() - 1);
-    }
-    else
-    {
-        return filter->getAverage(_filterSize);
-    }
+bool SensorSi1132Device::updateAll()
+{
+    const bool ready = (_interruptPin != SI1132_NO_INTERRUPT_PIN) ?
+        digitalRead(_interruptPin) == LOW : _phy.dataReady();
+    if (!ready)
+        return false;
+
+    float visible, ir;
+    uint16_t uv;
+    if (!_phy.readAll(&visible, &ir, &uv))
+        return false;
+
+    addDataPoint(SI1132_VISIBLE, visible);
+    addDataPoint(SI1132_IR, ir);
+    addDataPoint(SI1132_UV, uv);
+    return true;
 }
 
-void SensorSi1132::updateIR()
+void SensorSi1132Device::updateIR()
 {
     addDataPoint(SI1132_IR, _phy.readIR());
 }
 
-void SensorSi1132::updateVisible()
+void SensorSi1132Device::updateVisible()
 {
     addDataPoint(SI1132_VISIBLE, _phy.readVisible());
 }
 
-void SensorSi1132::updateUV()
+void SensorSi1132Device::updateUV()
 {
     addDataPoint(SI1132_UV, _phy.readUV());
 }
@@ -244,8 +395,9 @@ void SensorBattery::addDataPoint(uint8_t channel, float data)
         break;
 
     default:
-        break;
+        return;
     }
+    publish(channel);
 }
 
 float SensorBattery::readDataPoint(uint8_t channel = 0, bool getRawData = false)
@@ -328,6 +480,8 @@ void Touch::addDataPoint(uint8_t channel, float data)
             _touch.loc.x = ((TouchMessage*)touch)->touchData[0].x;
             _touch.loc.y = ((TouchMessage*)touch)->touchData[0].y;
             _touch.state = ((TouchMessage*)touch)->touchData[0].event;
+            publish(ZFORCE_X);
+            publish(ZFORCE_Y);
             // Serial.print("X/Y/Event: ");
             // Sprint(_touch.x);
             // Serial.print(" / ");
@@ -9,7 +9,7 @@
 
 #include <tgui-common.h>
 
-#include "RunningMedian.h"
+#include <tgui-filter.h>
 #include <Battery.h>
 #include <VL53L0X.h>
 #include <Adafruit_Sensor.h>
@@ -19,6 +19,14 @@
 
 /* Parameters */
 #define FILTER_SAMPLE_SIZE 7
+#define SI1132_NO_INTERRUPT_PIN 0xFF
+#define VL53L0X_NO_INTERRUPT_PIN 0xFF
+
+typedef MedianFilter<FILTER_SAMPLE_SIZE> SensorFilter;
+// heavy smoothing for slow channels such as pressure
+typedef FilterChain<SensorFilter, EmaFilter<3> > SlowSensorFilter;
+// one sample of lag, for channels that must follow quick changes
+typedef MedianFilter<3> FastSensorFilter;
 
 
 enum
@@ -56,82 +64,243 @@ enum
 };
 
 
-class SensorBME280 : public Sensor
+/*
+ * Sensors with filtered channels come in two parts: a device class that
+ * talks to the chip, and FilteredSensor on top, which holds a filter chain
+ * (see tgui-filter.h) and a table entry for each channel. Reading a channel
+ * is an index into the table. The templates give the usual defaults; for
+ * example, a sensor with a quicker temperature channel is
+ *   SensorBME280T<FastSensorFilter> bme = SensorBME280T<FastSensorFilter>(0x76);
+ * groupDelay() reports the lag of a channel in samples.
+ */
+template <typename Device, typename... Filters>
+class FilteredSensor : public Device
 {
 private:
-    uint16_t _address;
-    Adafruit_BME280 _phy;
-    RunningMedian _filter = RunningMedian(FILTER_SAMPLE_SIZE);
-    RunningMedian _filterHumidity = RunningMedian(FILTER_SAMPLE_SIZE);
-    RunningMedian _filterTemperature = RunningMedian(FILTER_SAMPLE_SIZE);
-    RunningMedian _filterAltitude = RunningMedian(FILTER_SAMPLE_SIZE);
-    void addDataPoint(uint8_t channel, float data);
+    FilterBank<Filters...> _filters;
+    SensorChannel _table[sizeof...(Filters)];
+
+    static_assert(sizeof...(Filters) == Device::CHANNELS, "one filter per sensor channel");
+
+protected:
+    void addDataPoint(uint8_t channel, float data)
+    {
+        if (channel >= Device::CHANNELS)
+            return;
+
+        _table[channel].raw = data;
+        _table[channel].value = _filters.add(channel, data);
+        _table[channel].generation++;
+        this->publish(channel);
+    }
 
 public:
-    SensorBME280(
+    FilteredSensor(
         uint16_t i2cAddress,
         uint16_t reportInterval = 100)
+        : Device(i2cAddress, reportInterval)
+    {
+        for (uint8_t i = 0; i < Device::CHANNELS; i++)
+        {
+            _table[i].value = NAN;
+            _table[i].raw = NAN;
+            _table[i].generation = 0;
+        }
+        this->_channels = _table;
+        this->_channelCount = Device::CHANNELS;
+    }
+
+    float readDataPoint(uint8_t channel = 0, bool getRawData = false)
+    {
+        if (channel >= Device::CHANNELS)
+            return NAN;
+
+        return getRawData ? _table[channel].raw : _table[channel].value;
+    }
+
+    // channel known at compile time, checked at compile time
+    template <uint8_t Channel>
+    const SensorChannel &at()
+    {
+        static_assert(Channel < Device::CHANNELS, "no such channel");
+        return _table[Channel];
+    }
+
+    template <uint8_t Channel>
+    void addSample(float data)
+    {
+        static_assert(Channel < Device::CHANNELS, "no such channel");
+        _table[Channel].raw = data;
+        _table[Channel].value = _filters.template get<Channel>().add(data);
+        _table[Channel].generation++;
+        this->publish(Channel);
+    }
+
+    float groupDelay(uint8_t channel = 0) { return _filters.groupDelay(channel); }
+};
+
+//------------------------- BME280 -------------------------------------/
+// Adafruit_BME280 plus a read of all channels in one bus transaction
+class BME280Burst : public Adafruit_BME280
+{
+public:
+    bool readAll(uint8_t address, float *temperature, float *pressure, float *humidity);
+    // start one forced conversion without waiting for it, unlike takeForcedMeasurement()
+    bool startForced(uint8_t address, uint8_t ctrlMeas);
+};
+
+class SensorBME280Device : public Sensor
+{
+protected:
+    uint16_t _address;
+    uint8_t _profile;
+    uint8_t _ctrlMeas;          // oversampling and mode, rewritten to start a forced conversion
+    uint8_t _measurementTime;   // ms, worst case
+    bool _forced;
+    uint32_t _conversionStart;
+    BME280Burst _phy;
+    void applyProfile();
+
+public:
+    enum
+    {
+        CHANNELS = BME280_ALTITUDE + 1
+    };
+
+    // measurement profiles, after the datasheet's recommended modes
+    enum
+    {
+        LIBRARY_DEFAULT = 0,    // normal mode, x16 everywhere, as Adafruit_BME280::begin() leaves it
+        WEATHER_STATION,        // forced mode, x1, one conversion per report interval
+        INDOOR,                 // normal mode, pressure x16, IIR x16, standby matched to the interval
+        HIGH_RATE               // normal mode, pressure x4, IIR x4, no standby
+    };
+
+    SensorBME280Device(
+        uint16_t i2cAddress,
+        uint16_t reportInterval)
     {
         _address = i2cAddress;
         _reportInterval = reportInterval;
-        _filterSize = _filter.getSize() / 2 + 1;
+        _profile = LIBRARY_DEFAULT;
+        _ctrlMeas = 0;
+        _measurementTime = 0;
+        _forced = false;
+        _conversionStart = 0;
     }
     void init();
-    float readDataPoint(uint8_t channel, bool getRawData);
+    void setProfile(uint8_t profile);
+    uint8_t getProfile() { return _profile; }
+    // worst case conversion time of the profile
+    uint8_t measurementTime() { return _measurementTime; }
+    // false while a forced conversion is still running
+    bool dataReady() { return !_forced || millis() - _conversionStart >= _measurementTime; }
+    // all four channels from one burst read, false on a bus error or while
+    // a forced conversion runs; the only update that works in forced mode
+    bool updateAll();
     void updateTemperature();
     void updateHumidity();
     void updatePressure();
     void updateAltitude();
 };
 
-class SensorVL53L0X : public Sensor
+template <typename TemperatureFilter = SensorFilter,
+          typename HumidityFilter = SensorFilter,
+          typename PressureFilter = SlowSensorFilter,
+          typename AltitudeFilter = SlowSensorFilter>
+using SensorBME280T = FilteredSensor<SensorBME280Device, TemperatureFilter, HumidityFilter, PressureFilter, AltitudeFilter>;
+
+typedef SensorBME280T<> SensorBME280;
+
+//------------------------ VL53L0X ---------------------------------------/
+class SensorVL53L0XDevice : public Sensor
 {
-private:
+protected:
     uint16_t _address;
+    uint8_t _interruptPin;
+    uint8_t _profile;
+    bool _running;
     VL53L0X _phy;
-    RunningMedian _filter = RunningMedian(FILTER_SAMPLE_SIZE);
-    void addDataPoint(uint8_t channel, float data);
+    void applyProfile();
 
 public:
-    SensorVL53L0X(
+    enum
+    {
+        CHANNELS = VL53L0X_DISTANCE + 1
+    };
+
+    // ranging profiles, LONG_RANGE combines with one of the others
+    enum
+    {
+        DEFAULT_PROFILE = 0,
+        LONG_RANGE = 0x01,      // weaker returns accepted, more noise
+        HIGH_SPEED = 0x02,      // 20 ms per range
+        HIGH_ACCURACY = 0x04    // 100 ms per range
+    };
+
+    SensorVL53L0XDevice(
         uint16_t i2cAddress,
-        uint16_t reportInterval = 100)
+        uint16_t reportInterval)
     {
         _address = i2cAddress;
         _reportInterval = reportInterval;
-        _filterSize = _filter.getSize() / 2 + 1;
+        _interruptPin = VL53L0X_NO_INTERRUPT_PIN;
+        _profile = LONG_RANGE | HIGH_ACCURACY;
+        _running = false;
     }
     void init();
-    float readDataPoint(uint8_t channel, bool getRawData);
-    void updateData();
+    void setProfile(uint8_t profile);
+    uint8_t getProfile() { return _profile; }
+    // GPIO1, if wired, saves the status poll; call before init()
+    void setInterruptPin(uint8_t pin) { _interruptPin = pin; }
+    // false if no range was ready
+    bool updateData();
 };
 
-class SensorSi1132 : public Sensor
+template <typename DistanceFilter = FastSensorFilter>
+using SensorVL53L0XT = FilteredSensor<SensorVL53L0XDevice, DistanceFilter>;
+
+typedef SensorVL53L0XT<> SensorVL53L0X;
+
+//------------------------ Si1132 ---------------------------------------/
+class SensorSi1132Device : public Sensor
 {
-private:
+protected:
     uint16_t _address;
+    uint8_t _interruptPin;
     ODROID_Si1132 _phy;
-    RunningMedian _filterIR = RunningMedian(FILTER_SAMPLE_SIZE);
-    RunningMedian _filter = RunningMedian(FILTER_SAMPLE_SIZE);
-    RunningMedian _filterUV = RunningMedian(FILTER_SAMPLE_SIZE);
-    void addDataPoint(uint8_t channel, float data);
 
 public:
-    SensorSi1132(
+    enum
+    {
+        CHANNELS = SI1132_UV + 1
+    };
+    SensorSi1132Device(
         uint16_t i2cAddress,
-        uint16_t reportInterval = 100)
+        uint16_t reportInterval)
     {
         _address = i2cAddress;
         _reportInterval = reportInterval;
-        _filterSize = _filter.getSize() / 2 + 1;
+        _interruptPin = SI1132_NO_INTERRUPT_PIN;
     }
     void init();
-    float readDataPoint(uint8_t channel, bool getRawData);
+    // the sensor's INT pin, if wired, saves the status poll; call before init()
+    void setInterruptPin(uint8_t pin) { _interruptPin = pin; }
+    // all channels in one burst once a measurement is ready, false if none was
+    bool updateAll();
     void updateIR();
     void updateVisible();
     void updateUV();
 };
 
+template <typename VisibleFilter = SensorFilter,
+          typename IRFilter = SensorFilter,
+          typename UVFilter = SensorFilter>
+using SensorSi1132T = FilteredSensor<SensorSi1132Device, VisibleFilter, IRFilter, UVFilter>;
+
+typedef SensorSi1132T<> SensorSi1132;
+
+//------------------------ Battery ---------------------------------------/
 class SensorBattery : public Sensor
 {
 private:
@@ -0,0 +1,399 @@
+/*!
+ * @file tgui-static.h
+ *
+ * Written by Wyng AB Sweden, visit us http://www.nordicalliance.eu
+ *
+ * Apache license.
+ *
+ */
+#pragma once
+
+#include <tgui.h>
+
+/*
+ * Widgets with their geometry, data range and sensor channel fixed at compile
+ * time. They are plain objects without a vtable: position, size and scale
+ * factors exist only as template arguments, and each object holds just the
+ * state it needs to draw the next sample. The scale factors become Q16
+ * constants, so an update costs one float to integer conversion and a 32-bit
+ * multiply with a shift, instead of the float divisions of the runtime
+ * widgets. Drawing goes through the same helpers as the runtime widgets.
+ * Sensor values are truncated to whole sensor units and clamped to the range.
+ * The widgets keep no display pointer; StaticScreen passes its display to
+ * init() and update().
+ */
+
+// Q16 factor mapping [0, span] onto [0, pixels], rounded down. A level then
+// lands at most one pixel below its exact position.
+constexpr uint32_t q16Scale(uint16_t pixels, uint16_t span)
+{
+    return ((uint32_t)pixels << 16) / span;
+}
+
+// The top of the range is clamped to the last pixel, everything below it
+// stays under that pixel
+inline uint16_t scaleToPixels(float value, uint16_t low, uint16_t high, uint32_t scale, uint16_t pixels)
+{
+    if (!(value > low))
+        return 0;
+
+    if (value >= high)
+        return pixels;
+
+    return ((uint32_t)((uint16_t)value - low) * scale) >> 16;
+}
+
+// One channel of a sensor object with static storage. Reads are direct calls
+// into SensorT, and the widget reading it stores no sensor pointer.
+template <typename SensorT, SensorT &Source, uint8_t Channel>
+struct StaticInput
+{
+    static float read() { return Source.SensorT::readDataPoint(Channel, false); };
+    static uint16_t parameters(uint16_t input) { return Source.SensorT::getParameters(input); };
+
+    // true when the channel got a sample since *seen, which then catches up
+    static bool newSample(uint16_t *seen)
+    {
+        if (!Source.changedSince(Channel, *seen))
+            return false;
+        *seen = Source.generation(Channel);
+        return true;
+    };
+};
+
+template <uint16_t X, uint16_t Y, uint8_t TextSize, uint8_t UnitSize, uint8_t Digits,
+          uint8_t Format, uint8_t UnitLocation, typename Input>
+class StaticLabel
+{
+    private:
+        static constexpr uint8_t cells = Digits < LABEL_MAX_CELLS ? Digits : LABEL_MAX_CELLS;
+        uint16_t _color;
+        const char *_unit;
+        float _value;
+        uint16_t _generation;
+        char _cells[cells];   // characters currently on screen, 0 if unknown
+
+    public:
+        StaticLabel(uint16_t color, const char *unit) : _color(color), _unit(unit), _value(NAN), _generation(0){};
+
+        void init(TguiDisplay *display)
+        {
+            const Size size = labelSize(TextSize, UnitSize, Digits, UnitLocation, _unit);
+            memset(_cells, 0, sizeof(_cells));
+            _value = NAN;   // the next update redraws every cell
+            _generation = 0;
+            drawWidgetBorder(display, {X, Y}, size, _color);
+            drawUnitText(display, {X, Y}, size, TextSize, UnitSize, UnitLocation, _color, _unit);
+        };
+
+        void update(TguiDisplay *display)
+        {
+            if (!Input::newSample(&_generation))
+                return;
+
+            const float value = Input::read();
+            if (value == _value)
+                return;
+            _value = value;
+
+            char text[cells + 1];
+            formatReading(text, cells, value, Format == Label::ONLY_INTEGER);
+            drawTextCells(display, NULL, {X, Y}, TextSize, _color, _cells, cells, text);
+        };
+};
+
+template <uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height,
+          uint16_t BlockWidth, uint16_t BlockHeight, uint16_t Resolution, uint16_t Ratio,
+          typename Input>
+class StaticProgressBar
+{
+    private:
+        static constexpr uint8_t totalBlocks = Width / Resolution;
+        static constexpr uint16_t fullScale = Ratio * 100;
+        static constexpr uint32_t blockScale = q16Scale(totalBlocks, fullScale);
+        uint16_t _color;
+        uint16_t _generation;
+        uint8_t _blocks;
+
+        static_assert(Width / Resolution <= 255, "a progress bar holds at most 255 blocks");
+        static_assert((uint32_t)Ratio * 100 <= 0xFFFF, "ratio * 100 must fit in 16 bits");
+
+    public:
+        StaticProgressBar(uint16_t color) : _color(color), _generation(0), _blocks(0){};
+
+        void init(TguiDisplay *display)
+        {
+            _blocks = 0;
+            drawWidgetBorder(display, {X, Y}, {Width, Height}, _color);
+        };
+
+        void update(TguiDisplay *display)
+        {
+            if (!Input::newSample(&_generation))
+                return;
+
+            const float value = Input::read();
+            if (value < 0)  // for now we don't take negtive values
+                return;
+
+            const uint8_t blocks = scaleToPixels(value, 0, fullScale, blockScale, totalBlocks);
+            if (blocks > _blocks)
+            {
+                drawBlockRun(display, NULL, {X, Y}, {BlockWidth, BlockHeight}, Resolution, _blocks, blocks, _color);
+            }
+            else if (blocks < _blocks)
+            {
+                drawBlockRun(display, NULL, {X, Y}, {BlockWidth, BlockHeight}, Resolution, blocks, _blocks, backgroundColor);
+            }
+            _blocks = blocks;
+        };
+};
+
+// The style and decimation are fixed too, so a BAR chart holds no bottoms
+template <uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height,
+          uint16_t Resolution, uint16_t RangeLow, uint16_t RangeHigh, typename Input,
+          uint8_t Style = RunningChart::BAR, uint8_t Decimation = 1>
+class StaticRunningChart
+{
+    private:
+        static constexpr uint16_t columns = Width / Resolution;
+        static constexpr uint32_t heightScale = q16Scale(Height, RangeHigh - RangeLow);
+        uint16_t _color;
+        uint16_t _timepoint;
+        uint8_t _mode;
+        ChartFold _fold;
+        // drawn top of every column, then the drawn bottoms unless BAR
+        uint8_t _spans[Style == RunningChart::BAR ? columns : 2 * columns];
+
+        static_assert(Height <= 255, "chart columns are stored in 8 bits");
+        static_assert(RangeHigh > RangeLow, "empty data range");
+        static_assert(Decimation > 0, "a column folds at least one sample");
+
+        void plot(TguiDisplay *display, uint8_t height)
+        {
+            uint8_t low;
+            uint8_t high;
+            if (!foldSample(&_fold, height, Decimation, Style, Height, &low, &high))
+                return;
+
+            const uint16_t previous = _timepoint;
+            if (++_timepoint == columns)
+            {
+                _timepoint = 0;
+            }
+
+            uint8_t *lows = _spans + columns;
+            const uint8_t beforeLow = (Style == RunningChart::BAR) ? 0 : lows[_timepoint];
+            drawColumnChange(display, NULL, X + Resolution * _timepoint, Y + Height, Resolution, _color,
+                             beforeLow, _spans[_timepoint], low, high);
+            _spans[_timepoint] = high;
+            if (Style != RunningChart::BAR)
+            {
+                lows[_timepoint] = low;
+            }
+
+            // the column is painted directly, without a compositor, so it is
+            // already on the panel when the scroll below brings it into view
+            if (_mode == RunningChart::SCROLLING)
+            {
+                // the column after the newest one goes to the left edge
+                uint16_t oldest = _timepoint + 1;
+                if (oldest == columns)
+                {
+                    oldest = 0;
+                }
+                display->scrollTo(X + Resolution * oldest);
+            }
+            else
+            {
+                drawChartMarker(display, X + Resolution * previous, Y, backgroundColor);
+                drawChartMarker(display, X + Resolution * _timepoint, Y, _color);
+            }
+        };
+
+    public:
+        StaticRunningChart(uint16_t color, uint8_t mode = RunningChart::WRAP_AROUND)
+            : _color(color), _timepoint(0), _mode(mode)
+        {
+            _fold.count = 0;
+            _fold.join = UINT8_MAX;
+        };
+
+        void init(TguiDisplay *display)
+        {
+            drawWidgetBorder(display, {X, Y}, {Width, Height}, _color);
+            _timepoint = 0;
+            _fold.count = 0;
+            _fold.join = UINT8_MAX;
+            memset(_spans, 0, sizeof(_spans));
+
+            if (_mode == RunningChart::SCROLLING && !chartCanScroll(display, {X, Y}, {Width, Height}))
+            {
+                _mode = RunningChart::WRAP_AROUND;
+            }
+
+            if (_mode == RunningChart::SCROLLING)
+            {
+                const uint16_t span = Resolution * columns;
+                display->defineScrollArea(X, span, display->scrollLines() - X - span);
+                display->scrollTo(X);
+            }
+
+            fillWidgetArea(display, NULL, X, Y, Width, Height, backgroundColor);
+        };
+
+        void update(TguiDisplay *display)
+        {
+            plot(display, scaleToPixels(Input::read(), RangeLow, RangeHigh, heightScale, Height));
+        };
+
+        bool isScrolling() { return _mode == RunningChart::SCROLLING; };
+};
+
+// Draws the cursor only; plots with a trail need the runtime XyPlot. The
+// touch state comes from InputX, like XyPlot asks its one sensor.
+template <uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height,
+          uint16_t LowX, uint16_t HighX, uint16_t LowY, uint16_t HighY,
+          typename InputX, typename InputY>
+class StaticXyPlot
+{
+    private:
+        static constexpr uint32_t scaleX = q16Scale(Width, HighX - LowX);
+        static constexpr uint32_t scaleY = q16Scale(Height, HighY - LowY);
+        uint16_t _color;
+        uint16_t _generationX;
+        uint16_t _generationY;
+        XyCursor _cursor;
+
+        static_assert(HighX > LowX && HighY > LowY, "empty data range");
+
+    public:
+        StaticXyPlot(uint16_t color) : _color(color), _generationX(0), _generationY(0)
+        {
+            _cursor.previous = {0, 0};
+            _cursor.redraw = true;
+            _cursor.shown = false;
+        };
+
+        void init(TguiDisplay *display)
+        {
+            _cursor.shown = false;
+            drawWidgetBorder(display, {X, Y}, {Width, Height}, _color);
+        };
+
+        void update(TguiDisplay *display)
+        {
+            // either axis may have moved, both generations have to catch up
+            const bool movedX = InputX::newSample(&_generationX);
+            const bool movedY = InputY::newSample(&_generationY);
+            if (!movedX && !movedY)
+                return;
+
+            Location loc;
+            loc.x = scaleToPixels(InputX::read(), LowX, HighX, scaleX, Width);
+            loc.y = scaleToPixels(InputY::read(), LowY, HighY, scaleY, Height);
+            moveCursor(display, {X, Y}, _color, &_cursor, &loc, InputX::parameters(XyPlot::SAME_LOCATION));
+        };
+};
+
+// Updates the wrapped widget only when the event counter returned by Trigger
+// has moved, like a trigger passed to TguiScreen::add()
+template <typename Widget, uint32_t (*Trigger)()>
+class Triggered : public Widget
+{
+    private:
+        uint32_t _lastTrigger;
+
+    public:
+        Triggered(const Widget &widget) : Widget(widget), _lastTrigger(0){};
+
+        void init(TguiDisplay *display)
+        {
+            _lastTrigger = Trigger();
+            Widget::init(display);
+        };
+
+        void update(TguiDisplay *display)
+        {
+            const uint32_t counter = Trigger();
+            if (counter == _lastTrigger)
+                return;
+
+            _lastTrigger = counter;
+            Widget::update(display);
+        };
+};
+
+/*
+ * A fixed set of widgets held by value, like a tuple. A member is any class
+ * with init(TguiDisplay *) and update(TguiDisplay *), such as the widgets
+ * above. init() and update() call every member directly, so there is no
+ * vtable, no widget pointer table, and the compiler can inline each update.
+ * The screen keeps the one display pointer its members draw on.
+ * Members run in the order they are listed. Reach a member with get<Index>().
+ */
+template <typename... Widgets>
+class StaticScreen;
+
+template <>
+class StaticScreen<>
+{
+    protected:
+        TguiDisplay *_display;
+
+    public:
+        StaticScreen() : _display(NULL){};
+        // attach to a panel, call before init()
+        void bind(TguiDisplay *display) { _display = display; };
+        void init(){};
+        void update(){};
+};
+
+template <uint8_t Index, typename Screen>
+struct StaticScreenSlot
+{
+    typedef StaticScreenSlot<Index - 1, typename Screen::Tail> Next;
+    typedef typename Next::Widget Widget;
+    static Widget &get(Screen &screen) { return Next::get(screen.tail()); };
+};
+
+template <typename Screen>
+struct StaticScreenSlot<0, Screen>
+{
+    typedef typename Screen::Head Widget;
+    static Widget &get(Screen &screen) { return screen.head(); };
+};
+
+template <typename First, typename... Rest>
+class StaticScreen<First, Rest...> : public StaticScreen<Rest...>
+{
+    private:
+        First _widget;
+
+    public:
+        typedef First Head;
+        typedef StaticScreen<Rest...> Tail;
+
+        StaticScreen(const First &first, const Rest &... rest) : Tail(rest...), _widget(first){};
+
+        void init()
+        {
+            _widget.init(this->_display);
+            Tail::init();
+        };
+
+        void update()
+        {
+            _widget.update(this->_display);
+            Tail::update();
+        };
+
+        Head &head() { return _widget; };
+        Tail &tail() { return *this; };
+
+        template <uint8_t Index>
+        typename StaticScreenSlot<Index, StaticScreen>::Widget &get()
+        {
+            return StaticScreenSlot<Index, StaticScreen>::get(*this);
+        };
+};
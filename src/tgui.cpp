@@ -9,14 +9,6 @@
 
 #include "tgui.h"
 
-#include <SPI.h>
-#include <Adafruit_ILI9340.h>
-
-/* REGISTERS */
-#define _cs 10
-#define _dc 9
-#define _rst 8
-
 /* COMMANDS */
 #define pbar_show_border
 
@@ -34,16 +26,14 @@
 #define widgetWidth (screenWidth - widgetStart - screenPadding)
 
 
-Adafruit_ILI9340 tft = Adafruit_ILI9340(_cs, _dc, _rst);
-
-void InitializeScreen()
+void InitializeScreen(TguiDisplay *display)
 {
-    tft.begin();
-    tft.setRotation(defaultRotation);
-    tft.fillScreen(backgroundColor);
+    display->begin();
+    display->screen->setRotation(defaultRotation);
+    display->screen->fillScreen(backgroundColor);
 }
 
-uint8_t countDigits(int num)
+uint8_t countDigits(int32_t num)
 {
     uint8_t count = 0;
     if (num < 0)
@@ -59,29 +49,278 @@ uint8_t countDigits(int num)
     return count;
 }
 
-uint8_t countFloatDigits(float num)
+const int32_t powersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+uint8_t formatNumber(char *buffer, uint8_t width, int32_t value, uint8_t decimals)
 {
-    uint8_t count = 0;
-    float threshold = 0.00005;
-    while (abs(num - round(num)) > threshold)
+    char digits[11];
+    uint8_t n = 0;
+    const bool negative = value < 0;
+    uint32_t magnitude = negative ? -(uint32_t)value : (uint32_t)value;
+
+    // least significant digit first, at least one digit before the point
+    do
     {
-        num *= 10.0;
-        threshold *= 10.0;
-        count++;
+        if (magnitude <= 0xFFFF)
+        {
+            const uint16_t small = magnitude;   // 16-bit division is much cheaper on AVR
+            digits[n++] = '0' + small % 10;
+            magnitude = small / 10;
+        }
+        else
+        {
+            digits[n++] = '0' + magnitude % 10;
+            magnitude /= 10;
+        }
+    } while (magnitude || n <= decimals);
+
+    const uint8_t length = negative + n + (decimals ? 1 : 0);
+    if (length > width)
+        return 0;
+
+    char *out = buffer;
+    if (negative)
+    {
+        *out++ = '-';
     }
-    return count;
+    while (n)
+    {
+        if (n == decimals)
+        {
+            *out++ = '.';
+        }
+        *out++ = digits[--n];
+    }
+    *out = '\0';
+    return length;
+}
+
+//------------------------ Glyphs ---------------------------------------/
+// The characters a numeric label can show, as row-major 6x8 cells of the
+// classic 5x7 GFX font. Bit 5 is the leftmost column.
+const uint8_t digitGlyphs[][8] PROGMEM = {
+    {0x1C, 0x22, 0x26, 0x2A, 0x32, 0x22, 0x1C, 0x00}, // '0'
+    {0x08, 0x18, 0x08, 0x08, 0x08, 0x08, 0x1C, 0x00}, // '1'
+    {0x1C, 0x22, 0x02, 0x04, 0x08, 0x10, 0x3E, 0x00}, // '2'
+    {0x3E, 0x04, 0x08, 0x04, 0x02, 0x22, 0x1C, 0x00}, // '3'
+    {0x04, 0x0C, 0x14, 0x24, 0x3E, 0x04, 0x04, 0x00}, // '4'
+    {0x3E, 0x20, 0x3C, 0x02, 0x02, 0x22, 0x1C, 0x00}, // '5'
+    {0x0C, 0x10, 0x20, 0x3C, 0x22, 0x22, 0x1C, 0x00}, // '6'
+    {0x3E, 0x02, 0x04, 0x08, 0x10, 0x10, 0x10, 0x00}, // '7'
+    {0x1C, 0x22, 0x22, 0x1C, 0x22, 0x22, 0x1C, 0x00}, // '8'
+    {0x1C, 0x22, 0x22, 0x1E, 0x02, 0x04, 0x18, 0x00}, // '9'
+    {0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00}, // '.'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+};
+
+int8_t glyphIndex(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+
+    switch (c)
+    {
+    case '-':
+        return 10;
+    case '.':
+        return 11;
+    case ' ':
+        return 12;
+
+    default:
+        return -1;
+    }
+}
+
+// Raw address-window access, when the display driver offers it.
+// Returns false when the caller has to fall back to Adafruit_GFX primitives.
+bool beginWindow(TguiDisplay *display, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (display == NULL)
+        return false;
+
+    if (x < 0 || y < 0 || x + w > display->screen->width() || y + h > display->screen->height())
+        return false;
+
+    return display->setWindow(x, y, w, h);
+}
+
+// Push one scaled glyph as a single address window followed by its pixels
+bool drawGlyph(TguiDisplay *display, char c, int16_t x, int16_t y, uint8_t size, uint16_t color, uint16_t bg)
+{
+    const int8_t index = glyphIndex(c);
+    if (index < 0)
+        return false;
+
+    if (!beginWindow(display, x, y, textPixelW(size), textPixelH(size)))
+        return false;
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        const uint8_t mask = pgm_read_byte(&digitGlyphs[index][row]);
+        for (uint8_t sy = 0; sy < size; sy++)
+        {
+            for (uint8_t bit = 0x20; bit; bit >>= 1)
+            {
+                display->pushRun((mask & bit) ? color : bg, size);
+            }
+        }
+    }
+    display->endWindow();
+    return true;
+}
+
+//------------------------ Compositor ---------------------------------------/
+#define rectArea(r) ((uint32_t)(r)->w * (r)->h)
+
+bool rectContains(const DamageRect *outer, const DamageRect *inner)
+{
+    return inner->x >= outer->x && inner->x + inner->w <= outer->x + outer->w &&
+           inner->y >= outer->y && inner->y + inner->h <= outer->y + outer->h;
+}
+
+bool rectIntersects(const DamageRect *a, const DamageRect *b)
+{
+    return a->x < b->x + b->w && b->x < a->x + a->w &&
+           a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+// Grow "into" to the union of both rectangles when that union is itself a rectangle
+bool rectCoalesce(DamageRect *into, const DamageRect *r)
+{
+    int16_t x0 = min(into->x, r->x);
+    int16_t y0 = min(into->y, r->y);
+    int16_t x1 = max(into->x + into->w, r->x + r->w);
+    int16_t y1 = max(into->y + into->h, r->y + r->h);
+
+    bool stackedVertically = (into->x == r->x) && (into->w == r->w) &&
+                             (r->y <= into->y + into->h) && (into->y <= r->y + r->h);
+    bool stackedHorizontally = (into->y == r->y) && (into->h == r->h) &&
+                               (r->x <= into->x + into->w) && (into->x <= r->x + r->w);
+
+    if (!stackedVertically && !stackedHorizontally && !rectContains(into, r))
+        return false;
+
+    into->x = x0;
+    into->y = y0;
+    into->w = x1 - x0;
+    into->h = y1 - y0;
+    return true;
+}
+
+TguiCompositor::TguiCompositor()
+{
+    _count = 0;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_lastFrame, 0, sizeof(_lastFrame));
+    display = NULL;
+}
+
+void TguiCompositor::remove(uint8_t index)
+{
+    _count--;
+    for (uint8_t i = index; i < _count; i++)
+    {
+        _queue[i] = _queue[i + 1];
+    }
+}
+
+void TguiCompositor::addRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (w <= 0 || h <= 0)
+        return;
+
+    DamageRect rect = {x, y, w, h, color};
+    _stats.rectsQueued++;
+
+    // Walk back from the newest entry. An older rectangle fully covered by the
+    // new one is dropped; one of the same color absorbs it, as long as nothing
+    // queued in between overlaps the new area.
+    uint8_t i = _count;
+    while (i > 0)
+    {
+        DamageRect *queued = &_queue[--i];
+
+        if (rectContains(&rect, queued))
+        {
+            _stats.pixelsSaved += rectArea(queued);
+            _stats.windowsSaved++;
+            remove(i);
+            continue;
+        }
+
+        if (queued->color == color)
+        {
+            uint32_t separate = rectArea(queued) + rectArea(&rect);
+            if (rectCoalesce(queued, &rect))
+            {
+                _stats.pixelsSaved += separate - rectArea(queued);
+                _stats.windowsSaved++;
+                return;
+            }
+        }
+
+        if (rectIntersects(queued, &rect))
+            break;
+    }
+
+    if (_count == COMPOSITOR_QUEUE_SIZE)
+    {
+        paint();
+    }
+    _queue[_count++] = rect;
+}
+
+void TguiCompositor::paint()
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        display->screen->fillRect(_queue[i].x, _queue[i].y, _queue[i].w, _queue[i].h, _queue[i].color);
+    }
+    _stats.rectsFlushed += _count;
+    _count = 0;
+}
+
+void TguiCompositor::flush()
+{
+    paint();
+    _lastFrame = _stats;
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 //------------------------ Tgui Element ---------------------------------------/
-void TguiElement::drawBorder()
+void fillWidgetArea(TguiDisplay *display, TguiCompositor *compositor, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 {
-    screen->drawRoundRect(
-        _loc.x - borderPadding * 2,
-        _loc.y - borderPadding,
-        _size.width + borderPadding * 4,
-        _size.height + borderPadding * 2,
+    if (compositor != NULL)
+    {
+        compositor->addRect(x, y, w, h, color);
+    }
+    else
+    {
+        display->screen->fillRect(x, y, w, h, color);
+    }
+}
+
+void drawWidgetBorder(TguiDisplay *display, Location loc, Size size, uint16_t color)
+{
+    display->screen->drawRoundRect(
+        loc.x - borderPadding * 2,
+        loc.y - borderPadding,
+        size.width + borderPadding * 4,
+        size.height + borderPadding * 2,
         4,
-        _color);
+        color);
+}
+
+void TguiElement::fillArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    fillWidgetArea(display, compositor, x, y, w, h, color);
+}
+
+void TguiElement::drawBorder()
+{
+    drawWidgetBorder(display, _loc, _size, _color);
 }
 
 //------------------------ Progress bar ---------------------------------------/
@@ -104,55 +343,86 @@ ProgressBar::ProgressBar(
     _dataType = dataType;
     _dataScaleRatio = ratio;
     _progress = 0;
-    screen = &tft,
+    _totalBlocks = size.width / resolution;
     _value = 0;
 }
 
 void ProgressBar::init()
 {
     _progress = 0;
+    _totalBlocks = _size.width / _resolution;
 #ifdef pbar_show_border
     drawBorder();
 #endif
 }
 
-void ProgressBar::drawBlocks(uint8_t previousProgress, uint8_t progress)
+// Paint the blocks in one go instead of one fill per block
+void drawBlockRun(TguiDisplay *display, TguiCompositor *compositor, Location loc, Size block, uint16_t resolution, uint8_t first, uint8_t last, uint16_t color)
 {
-    const uint8_t totalBlocks = _size.width / _resolution;
+    const uint8_t count = last - first;
+    const int16_t x = loc.x + resolution * first;
+    const int16_t width = resolution * (count - 1) + block.width;
 
-    const uint8_t before = totalBlocks * previousProgress / 100;
-    const uint8_t after = totalBlocks * progress / 100;
-    if(before == after)
+    // touching blocks, or clearing (the gaps are background already)
+    if (block.width >= resolution || color == backgroundColor)
+    {
+        fillWidgetArea(display, compositor, x, loc.y, width, block.height, color);
         return;
+    }
 
-    if(before < after)
+    if (beginWindow(display, x, loc.y, width, block.height))
     {
-        for (uint8_t i = before; i < after; i++)
+        const uint8_t gap = resolution - block.width;
+        for (uint16_t row = 0; row < block.height; row++)
         {
-            screen->fillRect(
-                _loc.x + _resolution * i,
-                _loc.y,
-                _block.width,
-                _block.height,
-                _color);
+            for (uint8_t i = 0; i < count; i++)
+            {
+                display->pushRun(color, block.width);
+                if (i != count - 1)
+                {
+                    display->pushRun(backgroundColor, gap);
+                }
+            }
         }
+        display->endWindow();
+        return;
+    }
+
+    for (uint8_t i = first; i < last; i++)
+    {
+        fillWidgetArea(
+            display,
+            compositor,
+            loc.x + resolution * i,
+            loc.y,
+            block.width,
+            block.height,
+            color);
+    }
+}
+
+void ProgressBar::drawBlocks(uint8_t previousProgress, uint8_t progress)
+{
+    const uint8_t before = _totalBlocks * previousProgress / 100;
+    const uint8_t after = _totalBlocks * progress / 100;
+    if(before == after)
+        return;
+
+    if(before < after)
+    {
+        drawBlockRun(display, compositor, _loc, _block, _resolution, before, after, _color);
     }
     else
     {
-        for (uint8_t i = after; i < before; i++)
-        {
-            screen->fillRect(
-                _loc.x + _resolution * i,
-                _loc.y,
-                _block.width,
-                _block.height,
-                backgroundColor);
-        }
+        drawBlockRun(display, compositor, _loc, _block, _resolution, after, before, backgroundColor);
     }
 }
 
 void ProgressBar::update()
 {
+    if (!newSample(_dataType, &_generation))
+        return;
+
     float value = _sensor->readDataPoint(_dataType, false);
 
     if (value < 0)  // for now we don't take negtive values
@@ -174,6 +444,111 @@ void ProgressBar::update()
 }
 
 //------------------------ Label ---------------------------------------/
+void formatReading(char *text, uint8_t width, float value, bool onlyInteger)
+{
+    const int32_t whole = (int32_t)value;
+
+    if (!onlyInteger && value != whole)
+    {
+        uint8_t nInteger = countDigits(whole);
+        if (whole == 0)
+        {
+            nInteger = (value < 0) ? 2 : 1;
+        }
+
+        // use every cell left after the integer part and the decimal point,
+        // giving one back if rounding carries into a new integer digit
+        int8_t decimals = width - 1 - nInteger;
+        while (decimals > 0)
+        {
+            if (formatNumber(text, width, lround(value * powersOfTen[decimals]), decimals))
+                return;
+            decimals--;
+        }
+    }
+
+    // lround keeps the full 32-bit range and rounds 99.95 up to 100
+    if (!formatNumber(text, width, lround(value), 0))
+    {
+        strcpy(text, "-");
+    }
+}
+
+Size labelSize(uint8_t textSize, uint8_t unitSize, uint8_t nDigitMax, bool unitLocation, const char *unit)
+{
+    Size size;
+    size.height = (unitLocation == Label::DRAW_ON_BOTTOM) ? textPixelH(textSize) + textPixelH(unitSize) : textPixelH(textSize);
+    size.width = (unitLocation == Label::DRAW_ON_BOTTOM) ? textPixelW(textSize) * nDigitMax : textPixelW(textSize) * nDigitMax + textPixelH(unitSize) * strlen(unit);
+    return size;
+}
+
+void drawUnitText(TguiDisplay *display, Location loc, Size size, uint8_t textSize, uint8_t unitSize, bool unitLocation, uint16_t color, const char *unit)
+{
+    Adafruit_GFX *screen = display->screen;
+    screen->setTextSize(unitSize);
+    screen->setTextColor(color, backgroundColor);
+    if (unitLocation == Label::DRAW_ON_BOTTOM)
+    {
+        screen->setCursor(loc.x, loc.y + textPixelH(textSize));
+    }
+    else
+    {
+        screen->setCursor(loc.x + size.width - strlen(unit) * textPixelW(unitSize), loc.y);
+    }
+
+    screen->print(unit);
+}
+
+void drawTextCell(TguiDisplay *display, char c, int16_t x, int16_t y, uint8_t size, uint16_t color)
+{
+    if (!drawGlyph(display, c, x, y, size, color, backgroundColor))
+    {
+        display->screen->drawChar(x, y, c, color, backgroundColor, size);
+    }
+}
+
+// Blank the cells with one fill
+void padTextCells(TguiDisplay *display, TguiCompositor *compositor, Location loc, uint8_t size, char *cells, uint8_t nCells, uint8_t first)
+{
+    while (first < nCells && cells[first] == ' ')
+    {
+        first++;
+    }
+
+    uint8_t last = nCells;
+    while (last > first && cells[last - 1] == ' ')
+    {
+        last--;
+    }
+
+    if (first == last)
+        return;
+
+    fillWidgetArea(
+        display,
+        compositor,
+        loc.x + first * textPixelW(size),
+        loc.y,
+        (last - first) * textPixelW(size),
+        textPixelH(size),
+        backgroundColor);
+    memset(&cells[first], ' ', last - first);
+}
+
+void drawTextCells(TguiDisplay *display, TguiCompositor *compositor, Location loc, uint8_t size, uint16_t color, char *cells, uint8_t nCells, const char *text)
+{
+    uint8_t i = 0;
+    for (; text[i] && i < nCells; i++)
+    {
+        if (cells[i] != text[i])
+        {
+            drawTextCell(display, text[i], loc.x + i * textPixelW(size), loc.y, size, color);
+            cells[i] = text[i];
+        }
+    }
+    padTextCells(display, compositor, loc, size, cells, nCells, i);
+}
+
 Label::Label(
     Location loc,
     uint16_t color,
@@ -191,104 +566,82 @@ Label::Label(
     _sensor = sensor;
     _value = 0;
     _dataType = dataType;
-    screen = &tft,
     _unit = unit;
     _textSize = textSize;
     _unitSize = unitSize;
     _nDigitMax = nDigitMax;
-    _size.height = (unitLocation == DRAW_ON_BOTTOM) ? textPixelH(textSize) + textPixelH(unitSize) : textPixelH(textSize);
-    _size.width = (unitLocation == DRAW_ON_BOTTOM) ? textPixelW(textSize) * nDigitMax : textPixelW(textSize) * nDigitMax + textPixelH(unitSize) * strlen(unit);
+    _size = labelSize(textSize, unitSize, nDigitMax, unitLocation, unit);
     _unitLocation = unitLocation;
     _onlyInteger = onlyInteger;
-}
-
-void Label::drawDigits(int value)
-{
-    screen->setTextSize(_textSize);
-    screen->setTextColor(_color, backgroundColor);
-    screen->setCursor(_loc.x, _loc.y);
-
-    uint8_t nDigits = countDigits(value);
 
-    if(nDigits <= _nDigitMax)
+    int16_t cellSpace = _size.width;
+    if (unitLocation == DRAW_ON_RIGHT)
     {
-        screen->print(value);
-        if(nDigits != _nDigitMax)
-        {
-            drawPadding(nDigits);
-        }
+        cellSpace -= strlen(unit) * textPixelW(unitSize);
     }
-    else
+    _nCells = cellSpace > 0 ? cellSpace / textPixelW(textSize) : 0;
+    if (_nCells > LABEL_MAX_CELLS)
     {
-        screen->print("-");
-        drawPadding(1);
+        _nCells = LABEL_MAX_CELLS;
     }
+    memset(_cells, 0, sizeof(_cells));
 }
 
-void Label::drawDigits(float value)
+void Label::drawCell(char c, int16_t x, int16_t y)
 {
-    screen->setTextSize(_textSize);
-    screen->setTextColor(_color, backgroundColor);
-    screen->setCursor(_loc.x, _loc.y);
+    drawTextCell(display, c, x, y, _textSize, _color);
+}
 
-    uint8_t nInteger = countDigits((int)value);
+void Label::drawText(const char *text)
+{
+    drawTextCells(display, compositor, _loc, _textSize, _color, _cells, _nCells, text);
+}
 
-    if((value == (int)value) || (nInteger + 2 > _nDigitMax))
-    {
-        drawDigits((int)value);
-    }
-    else
-    {
-        screen->print(value, _nDigitMax - 1 - nInteger);
-    }
+void Label::drawDigits(int value)
+{
+    char text[LABEL_MAX_CELLS + 1];
+    formatReading(text, min(_nDigitMax, LABEL_MAX_CELLS), value, true);
+    drawText(text);
+}
+
+void Label::drawDigits(float value)
+{
+    char text[LABEL_MAX_CELLS + 1];
+    formatReading(text, min(_nDigitMax, LABEL_MAX_CELLS), value, false);
+    drawText(text);
 }
 
 void Label::drawUnit()
 {
-    screen->setTextSize(_unitSize);
-    screen->setTextColor(_color, backgroundColor);
-    if (_unitLocation == DRAW_ON_BOTTOM)
-    {
-        screen->setCursor(_loc.x, _loc.y + textPixelH(_textSize));
-    }
-    else
-    {
-        screen->setCursor(_loc.x + _size.width - strlen(_unit) * textPixelW(_unitSize), _loc.y);
-    }
-        
-    screen->print(_unit);
+    drawUnitText(display, _loc, _size, _textSize, _unitSize, _unitLocation, _color, _unit);
 }
 
 void Label::drawPadding(uint8_t nDigits)
 {
-    const uint16_t textWidth = textPixelW(_textSize);
-    int16_t paddingLength = _size.width - nDigits * textWidth;
-    if (_unitLocation == DRAW_ON_RIGHT)
-    {
-        paddingLength -= strlen(_unit) * textPixelW(_unitSize);
-    }
-
-    if (paddingLength >= (int)textWidth)
-    {
-        screen->setTextSize(_textSize);
-        screen->setCursor(_loc.x + nDigits * textWidth, _loc.y);
-        for (uint8_t i = 0; i < (paddingLength / textWidth); i++)
-        {
-            screen->print(" ");
-        }
-    }
+    padTextCells(display, compositor, _loc, _textSize, _cells, _nCells, nDigits);
 }
 
+// After a page switch or fillScreen the next update repaints every cell,
+// even when the reading has not changed
 void Label::init()
 {
+    memset(_cells, 0, sizeof(_cells));
+    _value = NAN;
+    _generation = 0;
     drawBorder();
     drawUnit();
 }
 
 void Label::update()
 {
-    float value = _sensor->readDataPoint(_dataType, false);
+    if (!newSample(_dataType, &_generation))
+        return;
+
+    show(_sensor->readDataPoint(_dataType, false));
+}
 
+void Label::show(float value)
+{
     if (value == _value)
         return;
 
@@ -313,7 +666,8 @@ RunningChart::RunningChart(
             Sensor *sensor,
             uint8_t dataType,
             uint16_t dynamicRangeHigh,
-            uint16_t dynamicRangeLow)
+            uint16_t dynamicRangeLow,
+            uint8_t mode)
 {
     _loc = loc;
     _size = size;
@@ -323,9 +677,52 @@ RunningChart::RunningChart(
     _dataType = dataType;
     _dynamicRangeHigh = dynamicRangeHigh;
     _dynamicRangeLow = dynamicRangeLow;
-    screen = &tft,
+    _mode = mode;
     _value = 0;
     _timepoint = 0;
+    _style = BAR;
+    _decimation = 1;
+    _fold.count = 0;
+    _columns = size.width / resolution;
+    _history.allocate(_columns);
+
+    // column heights are stored in 8 bits
+    if (_size.height > UINT8_MAX)
+    {
+        _size.height = UINT8_MAX;
+    }
+}
+
+// Fold every "decimation" samples into one column. Call before init().
+void RunningChart::setStyle(uint8_t style, uint8_t decimation)
+{
+    _style = style;
+    _decimation = decimation ? decimation : 1;
+    if (_style != BAR && _historyLow == NULL)
+    {
+        _historyLow.allocate(_columns);
+    }
+}
+
+// The controller scrolls every pixel of the scrolled columns, so the chart
+// must own the full screen height and run along the scroll axis
+bool chartCanScroll(TguiDisplay *display, Location loc, Size size)
+{
+    Adafruit_GFX *screen = display->screen;
+
+    // screen x must be the scroll axis and cover every line of it
+    if (!display->canScroll() || screen->getRotation() != 1 ||
+        display->scrollLines() != (uint16_t)screen->width())
+        return false;
+
+    return (loc.y <= borderPadding) &&
+           (loc.y + size.height + borderPadding >= (uint16_t)screen->height()) &&
+           (loc.x + size.width <= (uint16_t)screen->width());
+}
+
+void drawChartMarker(TguiDisplay *display, int16_t x, int16_t y, uint16_t color)
+{
+    display->screen->drawTriangle(x - 4, y - 7, x, y - 3, x + 4, y - 7, color);
 }
 
 void RunningChart::drawIndicator()
@@ -333,26 +730,11 @@ void RunningChart::drawIndicator()
     uint16_t previousPoint = _timepoint - 1;
     if(_timepoint == 0)
     {
-        previousPoint = _size.width / _resolution - 1;
+        previousPoint = _columns - 1;
     }
 
-    screen->drawTriangle(
-        _loc.x + _resolution * previousPoint - 4,
-        _loc.y - 7,
-        _loc.x + _resolution * previousPoint,
-        _loc.y - 3,
-        _loc.x + _resolution * previousPoint + 4,
-        _loc.y - 7,
-        backgroundColor);
-
-    screen->drawTriangle(
-        _loc.x + _resolution * _timepoint - 4,
-        _loc.y - 7,
-        _loc.x + _resolution * _timepoint,
-        _loc.y - 3,
-        _loc.x + _resolution * _timepoint + 4,
-        _loc.y - 7,
-        _color);
+    drawChartMarker(display, _loc.x + _resolution * previousPoint, _loc.y, backgroundColor);
+    drawChartMarker(display, _loc.x + _resolution * _timepoint, _loc.y, _color);
 }
 
 uint16_t RunningChart::scaleValue(float value)
@@ -368,41 +750,172 @@ uint16_t RunningChart::scaleValue(float value)
     return pos;
 }
 
+void paintColumnSpan(TguiDisplay *display, TguiCompositor *compositor, int16_t x, int16_t bottom, uint16_t width, uint8_t low, uint8_t high, uint16_t color)
+{
+    if (high > low)
+    {
+        fillWidgetArea(display, compositor, x, bottom - high, width, high - low, color);
+    }
+}
+
+void drawColumnChange(TguiDisplay *display, TguiCompositor *compositor, int16_t x, int16_t bottom, uint16_t width, uint16_t color,
+                      uint8_t beforeLow, uint8_t before, uint8_t low, uint8_t high)
+{
+    if (beforeLow == before)
+    {
+        beforeLow = before = 0;
+    }
+
+    paintColumnSpan(display, compositor, x, bottom, width, beforeLow, min(before, low), backgroundColor);
+    paintColumnSpan(display, compositor, x, bottom, width, max(beforeLow, high), before, backgroundColor);
+    paintColumnSpan(display, compositor, x, bottom, width, low, min(high, beforeLow), color);
+    paintColumnSpan(display, compositor, x, bottom, width, max(low, before), high, color);
+}
+
+// Column spans are [low, high) in pixels above the chart bottom. Only the
+// parts that differ from the previously drawn span are painted.
+void RunningChart::drawColumn(uint16_t column, uint8_t low, uint8_t high)
+{
+    const int16_t x = _loc.x + _resolution * column;
+    const int16_t bottom = _loc.y + _size.height;
+
+    if (_history == NULL || (_style != BAR && _historyLow == NULL))
+    {
+        paintColumnSpan(display, compositor, x, bottom, _resolution, 0, _size.height, backgroundColor);
+        paintColumnSpan(display, compositor, x, bottom, _resolution, low, high, _color);
+        return;
+    }
+
+    const uint8_t beforeLow = (_style == BAR) ? 0 : _historyLow[column];
+    drawColumnChange(display, compositor, x, bottom, _resolution, _color, beforeLow, _history[column], low, high);
+
+    _history[column] = high;
+    if (_style != BAR)
+    {
+        _historyLow[column] = low;
+    }
+}
+
 void RunningChart::init()
 {
     drawBorder();
     _timepoint = 0;
+    _fold.count = 0;
+    _fold.join = UINT8_MAX;
+    if (_history != NULL)
+    {
+        memset(_history, 0, _columns);
+    }
+    if (_historyLow != NULL)
+    {
+        memset(_historyLow, 0, _columns);
+    }
+
+    if (_mode == SCROLLING && !chartCanScroll(display, _loc, _size))
+    {
+        _mode = WRAP_AROUND;
+    }
+
+    if (_mode == SCROLLING)
+    {
+        const uint16_t span = _resolution * _columns;
+        display->defineScrollArea(_loc.x, span, display->scrollLines() - _loc.x - span);
+        display->scrollTo(_loc.x);
+    }
+
+    // the history now says empty, so must the screen, e.g. after a page switch
+    fillArea(_loc.x, _loc.y, _size.width, _size.height, backgroundColor);
 }
 
 void RunningChart::update()
 {
     _value = _sensor->readDataPoint(_dataType, false);
+    plot(scaleValue(_value));
+}
 
-    if(_timepoint++ == (_size.width / _resolution - 1))
+bool foldSample(ChartFold *fold, uint8_t height, uint8_t decimation, uint8_t style, uint8_t top, uint8_t *low, uint8_t *high)
+{
+    if (fold->count++ == 0)
     {
-        _timepoint = 0;
+        fold->low = fold->high = height;
+    }
+    else
+    {
+        fold->low = min(fold->low, height);
+        fold->high = max(fold->high, height);
     }
 
-    uint16_t value = scaleValue(_value);
+    if (fold->count < decimation)
+        return false;
+    fold->count = 0;
 
-    screen->fillRect(
-        _loc.x + _resolution * _timepoint,
-        _loc.y + _size.height - value,
-        _resolution,
-        value,
-        _color);
+    *low = 0;
+    *high = fold->high;
+    if (style != RunningChart::BAR)
+    {
+        *low = fold->low;
+        if (style == RunningChart::LINE && fold->join != UINT8_MAX)
+        {
+            *low = min(*low, fold->join);
+            *high = max(*high, fold->join);
+        }
 
-    screen->fillRect(
-        _loc.x + _resolution * _timepoint,
-        _loc.y,
-        _resolution,
-        _size.height - value,
-        backgroundColor);
+        // a flat signal still needs one visible pixel
+        if (*high == *low)
+        {
+            if (*high < top)
+                (*high)++;
+            else
+                (*low)--;
+        }
+    }
+    fold->join = height;
+    return true;
+}
+
+// Add one sample, already scaled to pixels above the chart bottom
+void RunningChart::plot(uint8_t height)
+{
+    uint8_t low;
+    uint8_t high;
+    if (!foldSample(&_fold, height, _decimation, _style, _size.height, &low, &high))
+        return;
 
-    drawIndicator();
+    if(_timepoint++ == (_columns - 1))
+    {
+        _timepoint = 0;
+    }
+
+    drawColumn(_timepoint, low, high);
+
+    if (_mode == SCROLLING)
+    {
+        // show the column after the newest one at the left edge, so the newest
+        // sample sits on the right and older ones shift left every tick
+        uint16_t oldest = _timepoint + 1;
+        if (oldest == _columns)
+        {
+            oldest = 0;
+        }
+        // the new column has to be on the panel before it scrolls into view
+        if (compositor != NULL)
+        {
+            compositor->flush();
+        }
+        display->scrollTo(_loc.x + _resolution * oldest);
+    }
+    else
+    {
+        drawIndicator();
+    }
 }
 
 //------------------------ XY Plot ---------------------------------------/
+#define indicatorRadius 10
+
+// Half width of every row of Adafruit_GFX::fillCircle(r = 10), centre row first
+const uint8_t indicatorSpans[indicatorRadius + 1] PROGMEM = {10, 10, 10, 10, 9, 9, 8, 7, 6, 5, 3};
+
 XyPlot::XyPlot(
             Location loc,
             Size size,
@@ -413,7 +926,8 @@ XyPlot::XyPlot(
             Range rangeX,
             uint8_t dataTypeY,
             Range rangeY,
-            bool keepTrail)
+            bool keepTrail,
+            bool fadeTrail)
 {
     _loc = loc;
     _size = size;
@@ -422,36 +936,244 @@ XyPlot::XyPlot(
     _sensor = sensor;
     _dataTypeX = dataTypeX;
     _dataTypeY = dataTypeY;
+    _generationY = 0;
     _rangeX = rangeX;
     _rangeY = rangeY;
-    screen = &tft,
     _value = 0;
-    _previousLoc = {0, 0};
-    _redraw = true;
-    _keepTrail = keepTrail;
+    _cursor.previous = {0, 0};
+    _cursor.redraw = true;
+    _cursor.shown = false;
+    _fadeTrail = fadeTrail;
+    _trailStart = 0;
+    _trailCount = 0;
+    if (keepTrail)
+    {
+        _trail.allocate(XYPLOT_TRAIL_SIZE);
+    }
+}
+
+int16_t indicatorHalfWidth(int16_t centre, int16_t row)
+{
+    const int16_t dy = row > centre ? row - centre : centre - row;
+    return dy > indicatorRadius ? -1 : pgm_read_byte(&indicatorSpans[dy]);
 }
 
-void XyPlot::drawIndicator(Location* now, Location* before, bool drawNow, bool keepTrail)
+// Paint the pixels of [x0, x1] that are not inside [skip0, skip1]
+void drawSpanOutside(TguiDisplay *display, int16_t y, int16_t x0, int16_t x1, int16_t skip0, int16_t skip1, uint16_t color)
 {
-    if(!keepTrail)
+    if (skip1 < skip0)
+    {
+        display->fillSpan(x0, y, x1 - x0 + 1, color);
+        return;
+    }
+
+    const int16_t leftEnd = min(x1, skip0 - 1);
+    if (leftEnd >= x0)
     {
-        screen->fillCircle(
-            _loc.x + before->x,
-            _loc.y + before->y,
-            10,
-            backgroundColor);
+        display->fillSpan(x0, y, leftEnd - x0 + 1, color);
     }
 
-    if(drawNow == true)
+    const int16_t rightStart = max(x0, skip1 + 1);
+    if (x1 >= rightStart)
     {
-        screen->fillCircle(
-            _loc.x + now->x,
-            _loc.y + now->y,
-            10,
-            _color);
+        display->fillSpan(rightStart, y, x1 - rightStart + 1, color);
+    }
+}
+
+// Move the indicator disc from "before" to "now", both relative to the plot
+// at origin, by painting only the rows' symmetric difference. With keepTrail
+// the old disc stays on screen. "before" may be NULL when there is no disc
+// on screen yet.
+void drawCursor(TguiDisplay *display, Location origin, uint16_t color, Location *now, Location *before, bool drawNow, bool keepTrail)
+{
+    const int16_t nx = origin.x + now->x;
+    const int16_t ny = origin.y + now->y;
+    const bool useBefore = (before != NULL) && (!keepTrail || drawNow);
+    const bool eraseBefore = useBefore && !keepTrail;
+    const int16_t bx = useBefore ? origin.x + before->x : nx;
+    const int16_t by = useBefore ? origin.y + before->y : ny;
+
+    int16_t top = useBefore ? by - indicatorRadius : ny - indicatorRadius;
+    int16_t bottom = useBefore ? by + indicatorRadius : ny + indicatorRadius;
+    if (drawNow)
+    {
+        top = min(top, ny - indicatorRadius);
+        bottom = max(bottom, ny + indicatorRadius);
+    }
+
+    for (int16_t y = top; y <= bottom; y++)
+    {
+        const int16_t beforeHalf = useBefore ? indicatorHalfWidth(by, y) : -1;
+        const int16_t nowHalf = drawNow ? indicatorHalfWidth(ny, y) : -1;
+
+        if (eraseBefore && beforeHalf >= 0)
+        {
+            drawSpanOutside(display, y, bx - beforeHalf, bx + beforeHalf,
+                            nx - nowHalf, nx + nowHalf, backgroundColor);
+        }
+
+        if (nowHalf >= 0)
+        {
+            drawSpanOutside(display, y, nx - nowHalf, nx + nowHalf,
+                            bx - beforeHalf, bx + beforeHalf, color);
+        }
     }
 }
 
+#define diff(x, y) (x > y ? (x - y) : (y - x))
+
+// What a new touch sample does to the cursor: NEW_LOCATION once it moved at
+// least "threshold" pixels, NO_LOCATION on the first sample after a lift
+uint8_t trackCursor(XyCursor *cursor, Location *loc, bool lifted, uint8_t threshold)
+{
+    if (lifted)
+    {
+        if (!cursor->redraw)
+            return XyPlot::SAME_LOCATION;
+
+        cursor->redraw = false;
+        return XyPlot::NO_LOCATION;
+    }
+
+    if ((diff(loc->x, cursor->previous.x) + diff(loc->y, cursor->previous.y)) < threshold)
+        return XyPlot::SAME_LOCATION;
+
+    cursor->redraw = true;
+    return XyPlot::NEW_LOCATION;
+}
+
+void moveCursor(TguiDisplay *display, Location origin, uint16_t color, XyCursor *cursor, Location *loc, bool lifted)
+{
+    switch (trackCursor(cursor, loc, lifted, 3))
+    {
+    case XyPlot::NEW_LOCATION:
+        // after a lift or on the first touch there is no old disc to skip
+        drawCursor(display, origin, color, loc, cursor->shown ? &cursor->previous : NULL, true, false);
+        cursor->shown = true;
+        cursor->previous = *loc;
+        break;
+    case XyPlot::NO_LOCATION:
+        if (cursor->shown)
+        {
+            drawCursor(display, origin, color, &cursor->previous, &cursor->previous, false, false);
+        }
+        cursor->shown = false;
+        break;
+
+    default:
+        break;
+    }
+}
+
+uint16_t blendColor(uint16_t a, uint16_t b, uint8_t weight, uint8_t total)
+{
+    const uint8_t rest = total - weight;
+    const uint16_t red = (((a >> 11) & 0x1F) * weight + ((b >> 11) & 0x1F) * rest) / total;
+    const uint16_t green = (((a >> 5) & 0x3F) * weight + ((b >> 5) & 0x3F) * rest) / total;
+    const uint16_t blue = ((a & 0x1F) * weight + (b & 0x1F) * rest) / total;
+    return (red << 11) | (green << 5) | blue;
+}
+
+//------------------------ XY Plot trail ---------------------------------------/
+// Trail points are kept oldest first; "index" counts from the oldest point
+Location *XyPlot::trailPoint(uint8_t index)
+{
+    return &_trail[(_trailStart + index) % XYPLOT_TRAIL_SIZE];
+}
+
+uint8_t XyPlot::trailFadeStep(uint8_t age)
+{
+    return (uint16_t)age * TRAIL_FADE_STEPS / XYPLOT_TRAIL_SIZE;
+}
+
+uint16_t XyPlot::trailColor(uint8_t index)
+{
+    if (!_fadeTrail)
+        return _color;
+
+    const uint8_t step = trailFadeStep(_trailCount - 1 - index);
+    return blendColor(_color, backgroundColor, TRAIL_FADE_STEPS - step, TRAIL_FADE_STEPS);
+}
+
+// Paint the disc of one trail point, then restore the parts of younger
+// points that overlap it, so the stacking order on screen is unchanged
+void XyPlot::repaintTrailPoint(uint8_t index, uint16_t color)
+{
+    const int16_t cx = _loc.x + trailPoint(index)->x;
+    const int16_t cy = _loc.y + trailPoint(index)->y;
+
+    for (int16_t y = cy - indicatorRadius; y <= cy + indicatorRadius; y++)
+    {
+        const int16_t half = indicatorHalfWidth(cy, y);
+        display->fillSpan(cx - half, y, 2 * half + 1, color);
+
+        for (uint8_t i = index + 1; i < _trailCount; i++)
+        {
+            const int16_t px = _loc.x + trailPoint(i)->x;
+            const int16_t pHalf = indicatorHalfWidth(_loc.y + trailPoint(i)->y, y);
+            if (pHalf < 0)
+                continue;
+
+            const int16_t x0 = max(cx - half, px - pHalf);
+            const int16_t x1 = min(cx + half, px + pHalf);
+            if (x1 >= x0)
+            {
+                display->fillSpan(x0, y, x1 - x0 + 1, trailColor(i));
+            }
+        }
+    }
+}
+
+void XyPlot::addTrailPoint(Location *loc)
+{
+    if (_trailCount == XYPLOT_TRAIL_SIZE)
+    {
+        repaintTrailPoint(0, backgroundColor);
+        _trailStart = (_trailStart + 1) % XYPLOT_TRAIL_SIZE;
+        _trailCount--;
+    }
+
+    Location newest;
+    const bool hasNewest = _trailCount > 0;
+    if (hasNewest)
+    {
+        newest = *trailPoint(_trailCount - 1);
+    }
+
+    *trailPoint(_trailCount++) = *loc;
+    drawCursor(display, _loc, _color, loc, hasNewest ? &newest : NULL, true, true);
+
+    if (!_fadeTrail)
+        return;
+
+    // every point just aged by one, repaint those that crossed a fade step
+    for (uint8_t i = 0; i + 1 < _trailCount; i++)
+    {
+        const uint8_t age = _trailCount - 1 - i;
+        if (trailFadeStep(age) != trailFadeStep(age - 1))
+        {
+            repaintTrailPoint(i, trailColor(i));
+        }
+    }
+}
+
+// Clearing only touches the pixels the trail actually painted
+void XyPlot::clearTrail()
+{
+    for (uint8_t i = 0; i < _trailCount; i++)
+    {
+        const int16_t cx = _loc.x + trailPoint(i)->x;
+        const int16_t cy = _loc.y + trailPoint(i)->y;
+        for (int16_t y = cy - indicatorRadius; y <= cy + indicatorRadius; y++)
+        {
+            const int16_t half = indicatorHalfWidth(cy, y);
+            display->fillSpan(cx - half, y, 2 * half + 1, backgroundColor);
+        }
+    }
+    _trailStart = 0;
+    _trailCount = 0;
+}
+
 uint16_t XyPlot::scaleValue(float value, bool axis)
 {
     Range *range = (axis == AXIS_X) ? &_rangeX : &_rangeY;
@@ -461,64 +1183,214 @@ uint16_t XyPlot::scaleValue(float value, bool axis)
 
 void XyPlot::init()
 {
+    _trailStart = 0;
+    _trailCount = 0;
+    _cursor.shown = false;
     drawBorder();
 }
 
-#define diff(x, y) (x > y ? (x - y) : (y - x))
+// Either axis may have moved, both generations have to catch up
+bool XyPlot::newLocation()
+{
+    const bool movedX = newSample(_dataTypeX, &_generation);
+    const bool movedY = newSample(_dataTypeY, &_generationY);
+    return movedX || movedY;
+}
+
+void XyPlot::update()
+{
+    if (!newLocation())
+        return;
+
+    Location nowLoc;
+    nowLoc.x = scaleValue(_sensor->readDataPoint(_dataTypeX, false), AXIS_X);
+    nowLoc.y = scaleValue(_sensor->readDataPoint(_dataTypeY, false), AXIS_Y);
+    moveTo(&nowLoc, _sensor->getParameters(SAME_LOCATION));
+}
 
-bool XyPlot::matchLocation(Location *a, Location *b)
+// Move the indicator to a location in pixels inside the plot, or remove it
+// when the touch is lifted
+void XyPlot::moveTo(Location *loc, bool lifted)
 {
-    uint8_t threshold = _keepTrail ? 1 : 3;
-    if((diff(a->x,b->x) + diff(a->y, b->y)) < threshold)
+    // without trail memory the plot falls back to a plain cursor
+    if (_trail == NULL)
     {
-        return true;
+        moveCursor(display, _loc, _color, &_cursor, loc, lifted);
+        return;
     }
-    else
+
+    switch (trackCursor(&_cursor, loc, lifted, 1))
     {
+    case NEW_LOCATION:
+        addTrailPoint(loc);
+        _cursor.previous = *loc;
+        break;
+    case NO_LOCATION:
+        clearTrail();
+        break;
+
+    default:
+        break;
+    }
+}
+
+//------------------------ Screen ---------------------------------------/
+TguiScreen::TguiScreen(TguiDisplay *display, uint16_t frameBudget)
+{
+    _display = display;
+    _count = 0;
+    _polled = 0;
+    _pending = 0;
+    _budget = frameBudget;
+    _lastFrameTime = 0;
+    _carriedOver = 0;
+    compositor = NULL;
+}
+
+bool TguiScreen::add(TguiElement *widget, uint8_t priority, uint32_t (*trigger)())
+{
+    if (_count == SCREEN_MAX_WIDGETS)
         return false;
+
+    // keep the list sorted, equal priorities in registration order
+    uint8_t i = _count++;
+    while (i > 0 && _widgets[i - 1].priority < priority)
+    {
+        _widgets[i] = _widgets[i - 1];
+        i--;
     }
+
+    widget->bind(_display);
+    if (compositor != NULL)
+    {
+        widget->compositor = compositor;
+    }
+    _widgets[i].widget = widget;
+    _widgets[i].trigger = trigger;
+    _widgets[i].lastTrigger = (trigger != NULL) ? trigger() : 0;
+    _widgets[i].priority = priority;
+    _widgets[i].onSample = false;
+    _widgets[i].pending = false;
+    _polled++;
+    return true;
 }
 
-void XyPlot::update()
+// False when the widget was not added, or when its sensor has no room for
+// another listener; the widget is then polled every frame instead
+bool TguiScreen::addOnSample(TguiElement *widget, uint8_t priority)
 {
-    Location nowLoc;
-    nowLoc.x = scaleValue(_sensor->readDataPoint(_dataTypeX, false), AXIS_X);
-    nowLoc.y = scaleValue(_sensor->readDataPoint(_dataTypeY, false), AXIS_Y);
+    if (!add(widget, priority))
+        return false;
+
+    if (widget->_sensor == NULL || !widget->_sensor->subscribe(this))
+        return false;
 
-    uint8_t state = SAME_LOCATION;
-    if(_sensor->getParameters(state))
+    for (uint8_t i = 0; i < _count; i++)
     {
-        if(_redraw)
+        if (_widgets[i].widget == widget)
         {
-            state = NO_LOCATION;
-            _redraw = false;
+            _widgets[i].onSample = true;
+            break;
         }
     }
-    else if(!matchLocation(&nowLoc, &_previousLoc))
+    _polled--;
+    return true;
+}
+
+void TguiScreen::sampleArrived(Sensor *sensor, uint8_t channel)
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        ScheduledWidget *entry = &_widgets[i];
+        if (!entry->onSample || entry->pending || entry->widget->_sensor != sensor)
+            continue;
+
+        if (entry->widget->watches(channel))
+        {
+            entry->pending = true;
+            _pending++;
+        }
+    }
+}
+
+void TguiScreen::init()
+{
+    if (compositor != NULL)
+    {
+        compositor->bind(_display);
+    }
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        _widgets[i].widget->init();
+    }
+    if (compositor != NULL)
     {
-        state = NEW_LOCATION;
-        _redraw = true;
+        compositor->flush();
     }
+}
 
-    Sprintln(state);
+void TguiScreen::frame()
+{
+    // nothing polled and no samples arrived, nothing to draw
+    if (_polled == 0 && _pending == 0)
+    {
+        if (compositor != NULL)
+        {
+            compositor->flush();
+        }
+        _lastFrameTime = 0;
+        _carriedOver = 0;
+        return;
+    }
 
-    switch (state)
+    const uint32_t start = micros();
+
+    for (uint8_t i = 0; _polled && i < _count; i++)
     {
-    case NEW_LOCATION:
-        drawIndicator(&nowLoc, &_previousLoc, true, _keepTrail);
-        _previousLoc = nowLoc;
-        break;
-    case NO_LOCATION:
-        if(!_keepTrail)
+        ScheduledWidget *entry = &_widgets[i];
+        if (entry->onSample || entry->pending)
+            continue;
+
+        if (entry->trigger == NULL)
         {
-            drawIndicator(&nowLoc, &_previousLoc, false);
+            entry->pending = true;
+            _pending++;
+            continue;
         }
-        else
+
+        const uint32_t counter = entry->trigger();
+        if (counter != entry->lastTrigger)
         {
-            screen->fillRoundRect(_loc.x-1, _loc.y-1, _size.width+2, _size.height+2,5,backgroundColor);
+            entry->lastTrigger = counter;
+            entry->pending = true;
+            _pending++;
         }
-        
-    default:
-        break;
     }
-}
\ No newline at end of file
+
+    // at least one widget runs every frame, so a small budget cannot stall the screen
+    bool ranAny = false;
+    _carriedOver = 0;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        ScheduledWidget *entry = &_widgets[i];
+        if (!entry->pending)
+            continue;
+
+        if (ranAny && _budget && (micros() - start) >= _budget)
+        {
+            _carriedOver++;
+            continue;
+        }
+
+        entry->widget->update();
+        entry->pending = false;
+        _pending--;
+        ranAny = true;
+    }
+
+    if (compositor != NULL)
+    {
+        compositor->flush();
+    }
+    _lastFrameTime = micros() - start;
+}
@@ -6,8 +6,10 @@
  * Apache license.
  *
  */
+#pragma once
 
 #include <tgui-common.h>
+#include <tgui-display.h>
 
 #include <Adafruit_GFX.h>
 
@@ -17,8 +19,71 @@
 /* Parameters */
 #define foregroundColor 0xFFE0 //ILI9340_YELLOW
 #define backgroundColor 0x0016 //0x001F ILI9340_BLUE
+#define COMPOSITOR_QUEUE_SIZE 12
+#define LABEL_MAX_CELLS 8
+#define XYPLOT_TRAIL_SIZE 32
+#define SCREEN_MAX_WIDGETS 16
+#define TRAIL_FADE_STEPS 3
 
-void InitializeScreen();
+void InitializeScreen(TguiDisplay *display);
+
+// Write value / 10^decimals into buffer using at most width characters.
+// Returns the number of characters written, or 0 when it does not fit.
+uint8_t formatNumber(char *buffer, uint8_t width, int32_t value, uint8_t decimals);
+
+typedef struct DamageRect
+{
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    uint16_t color;
+} DamageRect;
+
+typedef struct CompositorStats
+{
+    uint16_t rectsQueued;
+    uint16_t rectsFlushed;
+    uint16_t windowsSaved;  // address-window commands that were never sent
+    uint32_t pixelsSaved;   // pixels that would have been written more than once
+} CompositorStats;
+
+/*
+ * Collects the solid fills of one loop pass, merges overlapping and adjacent
+ * rectangles of the same color, and pushes the result once per frame.
+ * Later fills still win over earlier ones, so widgets keep their draw order.
+ * That order only covers queued fills. Label glyphs, progress bar runs sent
+ * through a raw window, chart markers and the XyPlot cursor go straight to
+ * the display. Within one update they never overlap the widget's queued
+ * fills, but the queue has to be flushed after init() and between two
+ * updates of the same widget. TguiScreen does both.
+ */
+class TguiCompositor
+{
+    private:
+        DamageRect _queue[COMPOSITOR_QUEUE_SIZE];
+        uint8_t _count;
+        CompositorStats _stats;
+        CompositorStats _lastFrame;
+        void paint();
+        void remove(uint8_t index);
+
+    public:
+        TguiCompositor();
+        void addRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        void flush();
+        const CompositorStats *lastFrame() { return &_lastFrame; };
+        void bind(TguiDisplay *target) { display = target; };
+        TguiDisplay *display;
+};
+
+/*
+ * Drawing shared by the runtime widgets below and the compile-time widgets of
+ * tgui-static.h, which pass their geometry in. Fills go through the
+ * compositor when there is one.
+ */
+void fillWidgetArea(TguiDisplay *display, TguiCompositor *compositor, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void drawWidgetBorder(TguiDisplay *display, Location loc, Size size, uint16_t color);
 
 class TguiElement
 {
@@ -30,17 +95,41 @@ class TguiElement
         float _value;
         uint8_t _dataType;
         bool _showBorder;
+        uint16_t _generation;   // of the channel last drawn
+        void fillArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        // true when the channel got a sample since *seen, which then catches up
+        bool newSample(uint8_t channel, uint16_t *seen)
+        {
+            if (!_sensor->changedSince(channel, *seen))
+                return false;
+            *seen = _sensor->generation(channel);
+            return true;
+        };
 
     public:
-        TguiElement(){};
+        TguiElement() : _generation(0), screen(NULL), display(NULL), compositor(NULL){};
         ~TguiElement(){};
         virtual void init(){};
+        virtual void update(){};
         virtual void update(uint16_t value){};
+        // whether a sample on this channel of _sensor changes what is drawn
+        virtual bool watches(uint8_t channel) { return channel == _dataType; };
         void drawBorder();
+        // attach to a panel, call before init()
+        void bind(TguiDisplay *target)
+        {
+            display = target;
+            screen = target->screen;
+        };
         Sensor *_sensor;
         Adafruit_GFX *screen;
+        TguiDisplay *display;
+        TguiCompositor *compositor;
 };
 
+// Blocks [first, last) of a progress bar whose first block is at loc
+void drawBlockRun(TguiDisplay *display, TguiCompositor *compositor, Location loc, Size block, uint16_t resolution, uint8_t first, uint8_t last, uint16_t color);
+
 class ProgressBar : public TguiElement
 {
     private:
@@ -48,6 +137,7 @@ class ProgressBar : public TguiElement
         uint16_t _dataScaleRatio;
         Size _block;
         uint16_t _resolution;
+        uint8_t _totalBlocks;
 
     public:
         ProgressBar(
@@ -64,6 +154,15 @@ class ProgressBar : public TguiElement
         void drawBlocks(uint8_t previousProgress, uint8_t progress);
 };
 
+// Samples being folded into the next chart column, heights in pixels
+typedef struct ChartFold
+{
+    uint8_t count;
+    uint8_t low;
+    uint8_t high;
+    uint8_t join;   // height of the previous column, UINT8_MAX for none
+} ChartFold;
+
 class RunningChart : public TguiElement
 {
     private:
@@ -71,8 +170,17 @@ class RunningChart : public TguiElement
         uint16_t _resolution;
         uint16_t _dynamicRangeHigh;
         uint16_t _dynamicRangeLow;
+        uint16_t _columns;
+        uint8_t _mode;
+        uint8_t _style;
+        uint8_t _decimation;
+        ChartFold _fold;
+        HeapArray<uint8_t> _history;      // drawn top of every column
+        HeapArray<uint8_t> _historyLow;   // drawn bottom of every column, not used by BAR
         uint16_t scaleValue(float value);
         void drawIndicator();
+        void drawColumn(uint16_t column, uint8_t low, uint8_t high);
+        void plot(uint8_t height);
 
     public:
         RunningChart(
@@ -83,11 +191,50 @@ class RunningChart : public TguiElement
             Sensor *sensor,
             uint8_t dataType,
             uint16_t dynamicRangeHigh,
-            uint16_t dynamicRangeLow);
+            uint16_t dynamicRangeLow,
+            uint8_t mode = WRAP_AROUND);
         void init();
         void update();
+        void setStyle(uint8_t style, uint8_t decimation = 1);
+        bool isScrolling() { return _mode == SCROLLING; };
+
+    enum
+    {
+        WRAP_AROUND = 0,
+        SCROLLING = 1
+    };
+
+    enum
+    {
+        BAR = 0,        // filled bar up to the highest folded sample
+        ENVELOPE = 1,   // span between the lowest and highest folded sample
+        LINE = 2        // envelope stretched to join the previous column
+    };
 };
 
+// Fold one sample into *fold. True once "decimation" samples are in, with
+// the span [*low, *high) the column shows in a chart "top" pixels high.
+bool foldSample(ChartFold *fold, uint8_t height, uint8_t decimation, uint8_t style, uint8_t top, uint8_t *low, uint8_t *high);
+// Repaint a column from the span [beforeLow, before) it shows to [low, high),
+// painting only the pixels that differ. Heights count up from "bottom".
+void drawColumnChange(TguiDisplay *display, TguiCompositor *compositor, int16_t x, int16_t bottom, uint16_t width, uint16_t color,
+                      uint8_t beforeLow, uint8_t before, uint8_t low, uint8_t high);
+// The marker above the chart column starting at x
+void drawChartMarker(TguiDisplay *display, int16_t x, int16_t y, uint16_t color);
+bool chartCanScroll(TguiDisplay *display, Location loc, Size size);
+
+// Outline of a label, the digits plus its unit
+Size labelSize(uint8_t textSize, uint8_t unitSize, uint8_t nDigitMax, bool unitLocation, const char *unit);
+void drawUnitText(TguiDisplay *display, Location loc, Size size, uint8_t textSize, uint8_t unitSize, bool unitLocation, uint16_t color, const char *unit);
+// Text of a label value in at most width characters, "-" when it does not fit
+void formatReading(char *text, uint8_t width, float value, bool onlyInteger);
+void drawTextCell(TguiDisplay *display, char c, int16_t x, int16_t y, uint8_t size, uint16_t color);
+// Blank cells [first, nCells) of a text line at loc, skipping cells already blank
+void padTextCells(TguiDisplay *display, TguiCompositor *compositor, Location loc, uint8_t size, char *cells, uint8_t nCells, uint8_t first);
+// Draw text into a line of cells that remembers what is on screen, so only
+// changed cells are redrawn
+void drawTextCells(TguiDisplay *display, TguiCompositor *compositor, Location loc, uint8_t size, uint16_t color, char *cells, uint8_t nCells, const char *text);
+
 class Label : public TguiElement
 {
 private:
@@ -97,6 +244,9 @@ private:
     bool _unitLocation;
     uint8_t _nDigitMax;
     bool _onlyInteger;
+    uint8_t _nCells;
+    char _cells[LABEL_MAX_CELLS];   // characters currently on screen, 0 if unknown
+    void show(float value);
 
 public:
     Label(
@@ -116,6 +266,8 @@ public:
     void drawDigits(float value);
     void drawDigits(int value);
     void drawPadding(uint8_t nDigits);
+    void drawCell(char c, int16_t x, int16_t y);
+    void drawText(const char *text);
 
     enum
     {
@@ -130,20 +282,37 @@ public:
     };
 };
 
+// Where an XY plot cursor was last drawn
+typedef struct XyCursor
+{
+    Location previous;
+    bool redraw;    // a lift still has to remove the cursor or trail
+    bool shown;     // a disc is on screen at previous
+} XyCursor;
+
 class XyPlot : public TguiElement
 {
     private:
         uint16_t _resolution;
         Range _rangeX;
         Range _rangeY;
+        XyCursor _cursor;
+        bool _fadeTrail;
+        HeapArray<Location> _trail;   // ring of XYPLOT_TRAIL_SIZE points, only with keepTrail
+        uint8_t _trailStart;
+        uint8_t _trailCount;
         uint8_t _dataTypeX;
         uint8_t _dataTypeY;
-        Location _previousLoc;
-        bool _redraw;
-        bool _keepTrail;
+        uint16_t _generationY;
         uint16_t scaleValue(float value, bool axis);
-        void drawIndicator(Location* now, Location* before, bool drawNow, bool keepTrail = false);
-        bool matchLocation(Location *a, Location *b);
+        Location *trailPoint(uint8_t index);
+        uint8_t trailFadeStep(uint8_t age);
+        uint16_t trailColor(uint8_t index);
+        void repaintTrailPoint(uint8_t index, uint16_t color);
+        void addTrailPoint(Location *loc);
+        void clearTrail();
+        bool newLocation();
+        void moveTo(Location *loc, bool lifted);
 
     public:
         XyPlot(
@@ -156,9 +325,11 @@ class XyPlot : public TguiElement
             Range rangeX,
             uint8_t dataTypeY,
             Range rangeY,
-            bool keepTrail = false);
+            bool keepTrail = false,
+            bool fadeTrail = false);
         void init();
         void update();
+        bool watches(uint8_t channel) { return channel == _dataTypeX || channel == _dataTypeY; };
 
     enum
     {
@@ -172,4 +343,62 @@ class XyPlot : public TguiElement
         NEW_LOCATION = 1,
         SAME_LOCATION = 2
     };
-};
\ No newline at end of file
+};
+
+// Move a trail-less cursor at loc inside a plot at origin, or remove it when
+// the touch is lifted. Only the crescents between old and new disc are painted.
+void moveCursor(TguiDisplay *display, Location origin, uint16_t color, XyCursor *cursor, Location *loc, bool lifted);
+
+typedef struct ScheduledWidget
+{
+    TguiElement *widget;
+    uint32_t (*trigger)();  // event counter, NULL to update every frame
+    uint32_t lastTrigger;
+    uint8_t priority;
+    bool onSample;          // woken by its sensor instead of polled
+    bool pending;
+} ScheduledWidget;
+
+/*
+ * Owns the widget updates of one screen. Once per loop, frame() marks the
+ * widgets whose trigger counter moved, then updates pending widgets from the
+ * highest priority down until the frame budget is spent. Widgets that did
+ * not fit stay pending and run in a later frame.
+ * Widgets added with addOnSample() are not polled at all: the screen
+ * subscribes to their sensor and marks them when a sample they watch arrives,
+ * so a frame without new samples costs next to nothing.
+ * Widgets and the compositor are bound to the screen's display. Set the
+ * compositor before adding widgets: add() hands it to every widget, so
+ * their fills are coalesced without wiring each one by hand.
+ */
+class TguiScreen : public SampleListener
+{
+    private:
+        ScheduledWidget _widgets[SCREEN_MAX_WIDGETS];   // highest priority first
+        TguiDisplay *_display;
+        uint8_t _count;
+        uint8_t _polled;    // widgets that are not woken by samples
+        uint8_t _pending;
+        uint16_t _budget;
+        uint16_t _lastFrameTime;
+        uint8_t _carriedOver;
+
+    public:
+        TguiScreen(TguiDisplay *display, uint16_t frameBudget = 0);
+        bool add(TguiElement *widget, uint8_t priority = PRIORITY_NORMAL, uint32_t (*trigger)() = NULL);
+        bool addOnSample(TguiElement *widget, uint8_t priority = PRIORITY_NORMAL);
+        void sampleArrived(Sensor *sensor, uint8_t channel);
+        void init();
+        void frame();
+        uint16_t lastFrameTime() { return _lastFrameTime; };
+        uint8_t carriedOver() { return _carriedOver; };
+        TguiCompositor *compositor;
+
+    enum
+    {
+        PRIORITY_LOW = 0,
+        PRIORITY_NORMAL = 1,
+        PRIORITY_HIGH = 2,
+        PRIORITY_CRITICAL = 3
+    };
+};